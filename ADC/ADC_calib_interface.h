@@ -0,0 +1,83 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_calib_interface.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC (calibration / engineering units)
+
+
+/*
+   Raw counts -> engineering units without float or division at run time.
+
+   Millivolts: per channel, mv = (raw - offset) * k / 2^16 after raw is
+   scaled to 16 bits, with k = Vref * gain folded in whenever the reference
+   or the channel calibration changes. One conversion is a subtract, a
+   clamp and one 16x16->32 multiply of which only the high word is kept.
+
+   Non-linear sensors: 33 entry PROGMEM tables over the 10-bit range (one
+   point every 32 counts), generated by the compiler from a formula with
+   ADC_CALIB_LUT33(), read with linear interpolation. ADC_CALIB_NTC_DC()
+   is the formula for an NTC divider, see ADC_config.h; with the default
+   part the interpolation stays within 0.4 degC of the Beta model between
+   10 % and 90 % of full scale.
+
+   Cycle budgets (avr-gcc -Os, call included):
+     ADC_calibToMillivolts   ~35
+     ADC_calibLut            ~60
+*/
+
+
+#ifndef ADC_CALIB_INTERFACE_H
+#define ADC_CALIB_INTERFACE_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ADC_interface.h"
+#include "ADC_config.h"
+
+
+/* plain number -> Q14 gain (0..4), evaluated at compile time */
+#define ADC_CALIB_Q14(x)	((uint16_t)((x) * 16384.0 + 0.5))
+
+/* Table of F(raw) at raw = 0, 32, ..., 1024; F must be a constant expression */
+#define ADC_CALIB_LUT33(F) { \
+	F(0),    F(32),   F(64),   F(96),   F(128),  F(160),  F(192),  F(224),  \
+	F(256),  F(288),  F(320),  F(352),  F(384),  F(416),  F(448),  F(480),  \
+	F(512),  F(544),  F(576),  F(608),  F(640),  F(672),  F(704),  F(736),  \
+	F(768),  F(800),  F(832),  F(864),  F(896),  F(928),  F(960),  F(992),  \
+	F(1024) }
+
+/* NTC divider (ADC_CALIB_NTC_* in ADC_config.h): raw -> 0.1 degC, Beta
+   model, folded by the compiler. Both ends are clamped one count in. */
+#define ADC_CALIB_NTC_CLAMP(raw)	((raw) < 1 ? 1.0 : (raw) > 1023 ? 1023.0 : (double)(raw))
+#if ADC_CALIB_NTC_LOW_SIDE
+#define ADC_CALIB_NTC_OHM(raw)		(ADC_CALIB_NTC_SERIES_OHM * ADC_CALIB_NTC_CLAMP(raw) / (1024.0 - ADC_CALIB_NTC_CLAMP(raw)))
+#else
+#define ADC_CALIB_NTC_OHM(raw)		(ADC_CALIB_NTC_SERIES_OHM * (1024.0 - ADC_CALIB_NTC_CLAMP(raw)) / ADC_CALIB_NTC_CLAMP(raw))
+#endif
+#define ADC_CALIB_NTC_DC(raw)	((int16_t)__builtin_lround(10.0 * (1.0 / (1.0 / 298.15 + \
+		__builtin_log(ADC_CALIB_NTC_OHM(raw) / ADC_CALIB_NTC_R25_OHM) / ADC_CALIB_NTC_BETA) - 273.15)))
+
+
+/* Reference: nominal ADC_CALIB_VREF_MV until set or measured.
+   ADC_calibMeasureVref() converts the internal bandgap against ref and
+   derives the actual reference voltage from ADC_CALIB_BANDGAP_MV (put the
+   chip's measured bandgap there for best results). Needs the ADC idle;
+   returns the new Vref in mV, 0 if the reading is unusable. */
+void     ADC_calibSetVref(uint16_t vref_mv);
+uint16_t ADC_calibGetVref(void);
+uint16_t ADC_calibMeasureVref(adc_ref_t ref);
+
+/* Channel calibration, both recompute that channel's factor:
+   offset in counts (subtracted from raw), gain in Q14 (ADC_CALIB_Q14(1.0)
+   = ideal). TwoPoint derives both from two known inputs. */
+bool     ADC_calibSetChannel(adc_channel_t ch, int16_t offset, uint16_t gain_q14);
+bool     ADC_calibTwoPoint(adc_channel_t ch, uint16_t raw_lo, uint16_t mv_lo, uint16_t raw_hi, uint16_t mv_hi);
+
+/* Conversions. raw is a result of ADC_CALIB_RESULT_BITS bits. */
+uint16_t ADC_calibToMillivolts(adc_channel_t ch, uint16_t raw);
+int16_t  ADC_calibLut(const int16_t *lut_P, uint16_t raw);	/* lut_P in flash, raw 10-bit */
+#if ADC_CALIB_NTC_ENABLE
+int16_t  ADC_calibNtcDeciC(uint16_t raw);			/* built-in NTC table */
+#endif
+
+
+#endif
@@ -0,0 +1,135 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_calib_program.c   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC (calibration / engineering units)
+
+
+#include "ADC_calib_interface.h"
+#include "ADC_interface.h"
+#include "ADC_private.h"
+#include "ADC_config.h"
+#include <avr/pgmspace.h>
+
+
+#if (ADC_CALIB_RESULT_BITS < 10) || (ADC_CALIB_RESULT_BITS > 13)
+#error "ADC_CALIB_RESULT_BITS must be 10..13"
+#endif
+
+
+/* raw << CALIB_SHIFT spans 16 bits, so mv is the high word of raw16 * k:
+   mv = raw * Vref * gain / 2^bits without a division */
+#define CALIB_SHIFT	(16 - ADC_CALIB_RESULT_BITS)
+#define CALIB_MAX	((1u << ADC_CALIB_RESULT_BITS) - 1)
+
+
+static uint16_t adc_calib_vref =ADC_CALIB_VREF_MV;
+static adc_calib_ch_t adc_calib[ADC_NUM_CHANNELS] ={
+	[0 ... ADC_NUM_CHANNELS - 1] ={ .offset =0, .gain_q14 =ADC_CALIB_Q14(1.0), .k =ADC_CALIB_VREF_MV }
+};
+
+#if ADC_CALIB_NTC_ENABLE
+static const int16_t adc_calib_ntc_lut[33] PROGMEM = ADC_CALIB_LUT33(ADC_CALIB_NTC_DC);
+#endif
+
+
+/* Vref * gain, saturated; only runs when a calibration changes */
+static void adc_calib_update(adc_calib_ch_t *c) {
+	uint32_t k =((uint32_t)adc_calib_vref * c->gain_q14 + (1u << 13)) >> 14;
+	c->k =(k > 0xFFFF) ? 0xFFFF : (uint16_t)k;
+}
+
+
+/* ===================== Reference ===================== */
+
+void ADC_calibSetVref(uint16_t vref_mv) {
+	uint8_t i;
+
+	adc_calib_vref =vref_mv;
+	for (i =0; i < ADC_NUM_CHANNELS; i++) adc_calib_update(&adc_calib[i]);
+}
+
+uint16_t ADC_calibGetVref(void) {
+	return adc_calib_vref;
+}
+
+/* ADC = Vbg * 1024 / Vref  ->  Vref = Vbg * 1024 / ADC */
+uint16_t ADC_calibMeasureVref(adc_ref_t ref) {
+	adc_plan_t bg =ADC_PLAN(ADC_MUX_BANDGAP, ref, ADC_ALIGN_RIGHT);
+	uint16_t b;
+	uint32_t vref;
+
+	(void)ADC_readPlan(bg);		/* the bandgap settles after being selected */
+	b =ADC_readPlan(bg);
+	if (b == 0 || b >= 1023) return 0;
+
+	vref =((uint32_t)ADC_CALIB_BANDGAP_MV * 1024u + (b >> 1)) / b;
+	if (vref > 0xFFFF) return 0;
+	ADC_calibSetVref((uint16_t)vref);
+	return (uint16_t)vref;
+}
+
+
+/* ===================== Channels ===================== */
+
+bool ADC_calibSetChannel(adc_channel_t ch, int16_t offset, uint16_t gain_q14) {
+	adc_calib_ch_t *c;
+
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS) return false;
+	c =&adc_calib[ch];
+	c->offset	=offset;
+	c->gain_q14	=gain_q14;
+	adc_calib_update(c);
+	return true;
+}
+
+/* slope s = mV per count in Q16; gain = s * 2^bits / Vref, offset = raw_lo - mv_lo / s */
+bool ADC_calibTwoPoint(adc_channel_t ch, uint16_t raw_lo, uint16_t mv_lo, uint16_t raw_hi, uint16_t mv_hi) {
+	uint32_t s, g;
+	int32_t off;
+
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS || raw_hi <= raw_lo || mv_hi <= mv_lo || adc_calib_vref == 0) return false;
+
+	s =((uint32_t)(mv_hi - mv_lo) << 16) / (uint16_t)(raw_hi - raw_lo);
+	if (s == 0 || s > (0xFFFFFFFFUL >> (ADC_CALIB_RESULT_BITS - 2))) return false;
+
+	g =((s << (ADC_CALIB_RESULT_BITS - 2)) + (adc_calib_vref >> 1)) / adc_calib_vref;
+	if (g == 0 || g > 0xFFFF) return false;
+
+	off =(int32_t)raw_lo - (int32_t)((((uint32_t)mv_lo << 16) + (s >> 1)) / s);
+	if (off < -32768 || off > 32767) return false;
+
+	return ADC_calibSetChannel(ch, (int16_t)off, (uint16_t)g);
+}
+
+
+/* ===================== Conversions ===================== */
+
+uint16_t ADC_calibToMillivolts(adc_channel_t ch, uint16_t raw) {
+	const adc_calib_ch_t *c;
+	int16_t x;
+
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS) return 0;
+	c =&adc_calib[ch];
+	x =(int16_t)raw - c->offset;
+	if (x < 0) x =0;
+	else if (x > (int16_t)CALIB_MAX) x =(int16_t)CALIB_MAX;
+	return (uint16_t)(((uint32_t)((uint16_t)x << CALIB_SHIFT) * c->k) >> 16);
+}
+
+/* segment raw / 32, linear between its two table points */
+int16_t ADC_calibLut(const int16_t *lut_P, uint16_t raw) {
+	uint8_t idx, frac;
+	int16_t y0, y1;
+
+	if (raw > 1023) raw =1023;
+	idx	=(uint8_t)(raw >> 5);
+	frac	=(uint8_t)raw & 0x1F;
+	y0	=(int16_t)pgm_read_word(&lut_P[idx]);
+	y1	=(int16_t)pgm_read_word(&lut_P[idx + 1]);
+	return (int16_t)(y0 + ((((int32_t)y1 - y0) * frac) >> 5));
+}
+
+#if ADC_CALIB_NTC_ENABLE
+int16_t ADC_calibNtcDeciC(uint16_t raw) {
+	return ADC_calibLut(adc_calib_ntc_lut, raw);
+}
+#endif
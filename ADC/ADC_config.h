@@ -1,17 +1,122 @@
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_config.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-//Layer: MCAL
-//SWC  : ADC
-
-
-
-
-#ifndef _ADC_CONFIG_H_
-#define	_ADC_CONFIG_H_
-
-
-
-
-
-
-
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_config.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC
+
+
+
+
+#ifndef _ADC_CONFIG_H_
+#define	_ADC_CONFIG_H_
+
+
+/*========================================Scan Engine========================================*/
+/* Maximum number of entries accepted by ADC_scanStart() */
+#define ADC_SCAN_MAX_CHANNELS		8
+
+/* 1 = wrap around and keep scanning until ADC_scanStop()
+   0 = run the list once and stop (ADC_scanBusy() goes false) */
+#define ADC_SCAN_CONTINUOUS		1
+
+
+/*========================================Sample Ring========================================*/
+/* Samples buffered between ISR(ADC_vect) and the application.
+   Must be a power of two, at most 128 (indices are single bytes so that
+   producer and consumer can read each other's index atomically). */
+#define ADC_RING_SIZE			64
+
+
+/*========================================Conversion Clock========================================*/
+/* CPU clock, normally passed on the command line (-DF_CPU=...) */
+#ifndef F_CPU
+#define F_CPU				8000000UL
+#endif
+
+/* Window of ADC clocks that give the full 10-bit accuracy (datasheet) */
+#define ADC_CLOCK_MIN_HZ		50000UL
+#define ADC_CLOCK_MAX_HZ		200000UL
+
+/* Upper limit of the fast8 clock. Above 200 kHz the result degrades to
+   about 8 bits; much above 1 MHz it is not characterised. */
+#define ADC_FAST_CLOCK_MAX_HZ		1000000UL
+
+
+/*========================================Timer Paced Sampling========================================*/
+
+/* Timer used by ADC_startSampling(): TIMER_ID_1 (16-bit, compare B trigger,
+   finest rate resolution) or TIMER_ID_0 (8-bit, compare trigger).
+   Timer2 cannot trigger the ADC on ATmega32. */
+#define ADC_SAMPLING_TIMER		TIMER_ID_1
+
+
+/*========================================Noise Reduction Sleep========================================*/
+/* ADC_readSleep(): extra attempts when something other than ADC_vect wakes
+   the CPU in the middle of a conversion (0 = keep the noisy result). */
+#define ADC_SLEEP_RETRIES		1
+
+/* 1 = mask Timer2 interrupts (TOIE2/OCIE2) for the length of the conversion.
+   Timer0/1 run from clkI/O, which ADC Noise Reduction mode halts, so they
+   cannot wake the CPU (and do not count while it sleeps). Timer2 keeps
+   running when clocked asynchronously and its interrupts would end the
+   sleep early. Masked interrupts stay pending and run right afterwards. */
+#define ADC_SLEEP_MASK_TIMER2		1
+
+
+/*========================================Window Comparator========================================*/
+/* 1 = ISR(ADC_vect) checks every ADC0..ADC7 result against its window
+   (ADC_windowSet), 0 = compiled out */
+#define ADC_WINDOW_ENABLE		1
+
+
+/*========================================Calibration (ADC_calib_interface.h)========================================*/
+/* Reference voltage assumed until ADC_calibSetVref()/ADC_calibMeasureVref() */
+#define ADC_CALIB_VREF_MV		5000
+
+/* Internal bandgap used by ADC_calibMeasureVref() (datasheet 1.15..1.40 V,
+   1.22 V typical; measure it once per chip for a real correction) */
+#define ADC_CALIB_BANDGAP_MV		1220
+
+/* Width of the raw results handed to ADC_calibToMillivolts():
+   10, or 10 + oversample_bits (at most 13) */
+#define ADC_CALIB_RESULT_BITS		10
+
+/* Built-in NTC table (ADC_calibNtcDeciC): 1 = compile it (66 bytes flash).
+   LOW_SIDE 1: NTC between the pin and GND, series resistor to the
+   reference (ratiometric); 0: NTC on the reference side. */
+#define ADC_CALIB_NTC_ENABLE		1
+#define ADC_CALIB_NTC_LOW_SIDE		1
+#define ADC_CALIB_NTC_SERIES_OHM	10000.0
+#define ADC_CALIB_NTC_R25_OHM		10000.0
+#define ADC_CALIB_NTC_BETA		3950.0
+
+
+/*========================================Filters (ADC_filter_interface.h)========================================*/
+/* Moving average length = 2^ADC_FILT_MA_LOG2 taps.
+   Keep taps * largest sample <= 65535 (e.g. 64 taps of 10-bit data). */
+#define ADC_FILT_MA_LOG2		3
+
+/* First order IIR (exponential smoothing): y += alpha * (x - y),
+   alpha in Q7, 1..128 (128 = no filtering) */
+#define ADC_FILT_IIR1_ALPHA_Q7		16
+
+/* Second order IIR (biquad, direct form I), coefficients normalised to a0 = 1:
+   y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2.
+   Written as plain numbers, converted to Q14 by the compiler. Default is a
+   Butterworth low pass at fs/20. */
+#define ADC_FILT_BQ_B0			0.02008
+#define ADC_FILT_BQ_B1			0.04017
+#define ADC_FILT_BQ_B2			0.02008
+#define ADC_FILT_BQ_A1			(-1.56102)
+#define ADC_FILT_BQ_A2			0.64135
+
+/* Median window, 3 or 5 samples */
+#define ADC_FILT_MEDIAN_LEN		3
+
+/* Per-sample hook applied inside ISR(ADC_vect) to every scan/stream result,
+   after oversampling. ch is the channel the result belongs to. Bind a filter
+   at compile time, e.g.
+     #define ADC_ISR_FILTER(ch, v)  ADC_filtIir1Step(&my_iir[ch], (v))
+   (my_iir declared extern here, ADC_filter_interface.h is already included). */
+#define ADC_ISR_FILTER(ch, v)		(v)
+
+
 #endif	
\ No newline at end of file
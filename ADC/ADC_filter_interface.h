@@ -0,0 +1,80 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_filter_interface.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC (filter stage)
+
+
+/*
+   Fixed point streaming filters for ADC results. No float at run time:
+   coefficients come from ADC_config.h and are folded by the compiler.
+   Every filter has a per-sample Step (usable from ISR(ADC_vect) through
+   ADC_ISR_FILTER) and a Block variant for spans from the sample ring or
+   block capture (in == out is allowed).
+
+   Estimated cycles per sample (avr-gcc -Os, Step call included), counted
+   from the code, not measured; BENCH reports cycles.ADC_filt<name>Step
+   once it is run on avr-gcc/simavr:
+     moving average        ~40
+     first order IIR       ~50
+     biquad                ~170  (five 16x16->32 multiplies)
+     median of 3 / of 5    ~45 / ~110
+*/
+
+
+#ifndef ADC_FILTER_INTERFACE_H
+#define ADC_FILTER_INTERFACE_H
+
+
+#include <stdint.h>
+#include "ADC_config.h"
+
+
+#define ADC_FILT_MA_LEN		(1u << ADC_FILT_MA_LOG2)
+
+/* plain number -> Q14 (range -2..+2), evaluated at compile time */
+#define ADC_FILT_Q14(x)		((int16_t)((x) * 16384.0 + (((x) >= 0) ? 0.5 : -0.5)))
+
+
+/* Moving average over ADC_FILT_MA_LEN samples, O(1) running sum */
+typedef struct {
+	uint16_t	buf[ADC_FILT_MA_LEN];
+	uint16_t	sum;
+	uint8_t		idx;
+} ADC_FiltMa_t;
+
+/* First order IIR, state kept in Q7 so small steps are not lost */
+typedef struct {
+	int32_t		y_q7;
+} ADC_FiltIir1_t;
+
+/* Biquad, direct form I */
+typedef struct {
+	int16_t		x1, x2;
+	int16_t		y1, y2;
+} ADC_FiltBiquad_t;
+
+/* Median over the last ADC_FILT_MEDIAN_LEN samples */
+typedef struct {
+	uint16_t	win[ADC_FILT_MEDIAN_LEN];
+	uint8_t		idx;
+} ADC_FiltMedian_t;
+
+
+/* Init primes the state with x0 so the output starts settled at x0 */
+void     ADC_filtMaInit(ADC_FiltMa_t *f, uint16_t x0);
+uint16_t ADC_filtMaStep(ADC_FiltMa_t *f, uint16_t x);
+void     ADC_filtMaBlock(ADC_FiltMa_t *f, const uint16_t *in, uint16_t *out, uint16_t n);
+
+void     ADC_filtIir1Init(ADC_FiltIir1_t *f, uint16_t x0);
+uint16_t ADC_filtIir1Step(ADC_FiltIir1_t *f, uint16_t x);
+void     ADC_filtIir1Block(ADC_FiltIir1_t *f, const uint16_t *in, uint16_t *out, uint16_t n);
+
+void     ADC_filtBiquadInit(ADC_FiltBiquad_t *f, uint16_t x0);
+uint16_t ADC_filtBiquadStep(ADC_FiltBiquad_t *f, uint16_t x);
+void     ADC_filtBiquadBlock(ADC_FiltBiquad_t *f, const uint16_t *in, uint16_t *out, uint16_t n);
+
+void     ADC_filtMedianInit(ADC_FiltMedian_t *f, uint16_t x0);
+uint16_t ADC_filtMedianStep(ADC_FiltMedian_t *f, uint16_t x);
+void     ADC_filtMedianBlock(ADC_FiltMedian_t *f, const uint16_t *in, uint16_t *out, uint16_t n);
+
+
+#endif /* ADC_FILTER_INTERFACE_H */
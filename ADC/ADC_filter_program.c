@@ -0,0 +1,132 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_filter_program.c   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC (filter stage)
+
+
+#include "ADC_filter_interface.h"
+#include "ADC_config.h"
+
+
+#if (ADC_FILT_IIR1_ALPHA_Q7 < 1) || (ADC_FILT_IIR1_ALPHA_Q7 > 128)
+#error "ADC_FILT_IIR1_ALPHA_Q7 must be 1..128"
+#endif
+
+#if (ADC_FILT_MEDIAN_LEN != 3) && (ADC_FILT_MEDIAN_LEN != 5)
+#error "ADC_FILT_MEDIAN_LEN must be 3 or 5"
+#endif
+
+
+/* Q14 biquad coefficients, folded at compile time */
+#define BQ_B0	ADC_FILT_Q14(ADC_FILT_BQ_B0)
+#define BQ_B1	ADC_FILT_Q14(ADC_FILT_BQ_B1)
+#define BQ_B2	ADC_FILT_Q14(ADC_FILT_BQ_B2)
+#define BQ_A1	ADC_FILT_Q14(ADC_FILT_BQ_A1)
+#define BQ_A2	ADC_FILT_Q14(ADC_FILT_BQ_A2)
+
+/* compare-exchange for the median networks */
+#define FILT_SORT(a, b)	do { if ((a) > (b)) { uint16_t t_ =(a); (a) =(b); (b) =t_; } } while (0)
+
+
+/* ===================== Moving average ===================== */
+
+void ADC_filtMaInit(ADC_FiltMa_t *f, uint16_t x0) {
+	uint8_t i;
+	for (i = 0; i < ADC_FILT_MA_LEN; i++) f->buf[i] =x0;
+	f->sum =(uint16_t)(x0 << ADC_FILT_MA_LOG2);
+	f->idx =0;
+}
+
+uint16_t ADC_filtMaStep(ADC_FiltMa_t *f, uint16_t x) {
+	uint8_t i =f->idx;
+	f->sum	+=x - f->buf[i];	/* drop the oldest, add the newest */
+	f->buf[i] =x;
+	f->idx	=(i + 1) & (ADC_FILT_MA_LEN - 1);
+	return f->sum >> ADC_FILT_MA_LOG2;
+}
+
+void ADC_filtMaBlock(ADC_FiltMa_t *f, const uint16_t *in, uint16_t *out, uint16_t n) {
+	while (n--) *out++ =ADC_filtMaStep(f, *in++);
+}
+
+
+/* ===================== First order IIR ===================== */
+
+void ADC_filtIir1Init(ADC_FiltIir1_t *f, uint16_t x0) {
+	f->y_q7 =(int32_t)x0 << 7;
+}
+
+uint16_t ADC_filtIir1Step(ADC_FiltIir1_t *f, uint16_t x) {
+	/* alpha is a constant: the multiply folds to shifts/adds */
+	int32_t err =((int32_t)x << 7) - f->y_q7;
+	f->y_q7 +=(err * ADC_FILT_IIR1_ALPHA_Q7) >> 7;
+	return (uint16_t)((f->y_q7 + 64) >> 7);
+}
+
+void ADC_filtIir1Block(ADC_FiltIir1_t *f, const uint16_t *in, uint16_t *out, uint16_t n) {
+	while (n--) *out++ =ADC_filtIir1Step(f, *in++);
+}
+
+
+/* ===================== Biquad ===================== */
+
+void ADC_filtBiquadInit(ADC_FiltBiquad_t *f, uint16_t x0) {
+	/* unity DC gain assumed: settled output equals the input */
+	f->x1 =f->x2 =(int16_t)x0;
+	f->y1 =f->y2 =(int16_t)x0;
+}
+
+uint16_t ADC_filtBiquadStep(ADC_FiltBiquad_t *f, uint16_t x) {
+	int32_t acc;
+	int16_t y;
+
+	acc  =(int32_t)BQ_B0 * (int16_t)x;
+	acc +=(int32_t)BQ_B1 * f->x1;
+	acc +=(int32_t)BQ_B2 * f->x2;
+	acc -=(int32_t)BQ_A1 * f->y1;
+	acc -=(int32_t)BQ_A2 * f->y2;
+	y =(int16_t)((acc + (1L << 13)) >> 14);
+
+	f->x2 =f->x1; f->x1 =(int16_t)x;
+	f->y2 =f->y1; f->y1 =y;
+	return (y < 0) ? 0 : (uint16_t)y;
+}
+
+void ADC_filtBiquadBlock(ADC_FiltBiquad_t *f, const uint16_t *in, uint16_t *out, uint16_t n) {
+	while (n--) *out++ =ADC_filtBiquadStep(f, *in++);
+}
+
+
+/* ===================== Median ===================== */
+
+void ADC_filtMedianInit(ADC_FiltMedian_t *f, uint16_t x0) {
+	uint8_t i;
+	for (i = 0; i < ADC_FILT_MEDIAN_LEN; i++) f->win[i] =x0;
+	f->idx =0;
+}
+
+uint16_t ADC_filtMedianStep(ADC_FiltMedian_t *f, uint16_t x) {
+	uint16_t p0, p1, p2;
+#if ADC_FILT_MEDIAN_LEN == 5
+	uint16_t p3, p4;
+#endif
+
+	f->win[f->idx] =x;
+	if (++f->idx == ADC_FILT_MEDIAN_LEN) f->idx =0;
+
+	p0 =f->win[0]; p1 =f->win[1]; p2 =f->win[2];
+#if ADC_FILT_MEDIAN_LEN == 3
+	FILT_SORT(p0, p1); FILT_SORT(p1, p2); FILT_SORT(p0, p1);
+	return p1;
+#else
+	/* 7 compare-exchanges, only the middle element is fully sorted */
+	p3 =f->win[3]; p4 =f->win[4];
+	FILT_SORT(p0, p1); FILT_SORT(p3, p4); FILT_SORT(p0, p3);
+	FILT_SORT(p1, p4); FILT_SORT(p1, p2); FILT_SORT(p2, p3);
+	FILT_SORT(p1, p2);
+	return p2;
+#endif
+}
+
+void ADC_filtMedianBlock(ADC_FiltMedian_t *f, const uint16_t *in, uint16_t *out, uint16_t n) {
+	while (n--) *out++ =ADC_filtMedianStep(f, *in++);
+}
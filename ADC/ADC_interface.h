@@ -1,115 +1,268 @@
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_interface.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-//Layer: MCAL
-//SWC  : ADC
-
-
-/* 
-   adc.h  -- simple configurable ADC driver for ATmega32
-   Usage: include <avr/io.h> and this header. Implemented with avr-gcc ISR(ADC_vect).
-*/
-
-
-#ifndef ADC_INTERFACE_H
-#define ADC_INTERFACE_H
-
-
-#include <stdint.h>
-#include <stdbool.h>
-
-
-/* Reference selections (maps to ADMUX REFS1:REFS0) */
-typedef enum {
-	ADC_REF_AREF=0x00,
-	ADC_REF_AVCC=0x40,
-	ADC_REF_INTERNAL_2V56=0xC0
-}adc_ref_t;
-
-/*Result alignment*/
-typedef enum{
-	ADC_ALIGN_RIGHT =0,
-	ADC_ALIGN_LEFT 	=1
-}adc_align_t;
-
-/* Prescaler value to write into ADPS2..0 (0..7) — use defined constants below */
-typedef uint8_t adc_prescaler_t;
-
-
-/* Auto-trigger sources (ADTS2..0 in SFIOR) */
-typedef enum {
-	ADC_TRIG_FREE_RUNNING =0,
-	ADC_TRIG_ANALOG_COMP  =1,
-	ADC_TRIG_EXT_INT0     =2,
-	ADC_TRIG_TIMER0_COMP  =3,
-	ADC_TRIG_TIMER0_OVF   =4,
-	ADC_TRIG_TIMER1_COMPB =5,
-	ADC_TRIG_TIMER1_OVF   =6,
-	ADC_TRIG_TIMER1_CAPTURE =7
-}adc_trig_t;
-
-/* ADC channels (single ended) - values are MUX4..0 */
-typedef enum {
-    ADC_CH0 = 0,
-    ADC_CH1 = 1,
-    ADC_CH2 = 2,
-    ADC_CH3 = 3,
-    ADC_CH4 = 4,
-    ADC_CH5 = 5,
-    ADC_CH6 = 6,
-    ADC_CH7 = 7
-} adc_channel_t;
-
-typedef void (*adc_callback_t)(uint16_t adc_value);
-
-
-/* Configuration structure */
-
-typedef struct {
-	adc_ref_t	ref;			/* reference selection */
-	adc_align_t	align;			/* left/right adjust */
-	adc_prescaler	prescaler:		/* ADPS2..0 (0..7) */
-	bool		auto_trigger;	 	/* ADATE */
-	adc_trig_t	trigger_src;		/* ADTS */
-	bool		interrupt_enable;	/* ADIE */
-	uint8_t		didr_mask;		/* bits to set in DIDR0 to disable digital inputs (bit i = ADCi) */
-} ADC_Config_t;
-
-
-
-
-/* API */
-void ADC_init(const ADC_Config_t *cfg);
-void ADC_enable(void);
-void ADC_disable(void);
-uint16_t ADC_readBlocking(adc_channel_t ch); /* returns 0..1023 */
-uint8_t  ADC_read8(adc_channel_t ch);        /* returns 0..255 using left adjust */
-void     ADC_startConversion(adc_channel_t ch);
-bool     ADC_conversionInProgress(void);
-void     ADC_setAutoTrigger(adc_trigger_t src, bool enable);
-void     ADC_setCallback(adc_callback_t cb); /* enable interrupt in config to use callback */
-
-
-#endif /* ADC_INTERFACE_H */
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_interface.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC
+
+
+/* 
+   adc.h  -- simple configurable ADC driver for ATmega32
+   Usage: include <avr/io.h> and this header. Implemented with avr-gcc ISR(ADC_vect).
+*/
+
+
+#ifndef ADC_INTERFACE_H
+#define ADC_INTERFACE_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ADC_config.h"		/* F_CPU and the ADC clock window */
+
+
+/* Reference selections (maps to ADMUX REFS1:REFS0) */
+typedef enum {
+	ADC_REF_AREF=0x00,
+	ADC_REF_AVCC=0x40,
+	ADC_REF_INTERNAL_2V56=0xC0
+}adc_ref_t;
+
+/*Result alignment*/
+typedef enum{
+	ADC_ALIGN_RIGHT =0,
+	ADC_ALIGN_LEFT 	=1
+}adc_align_t;
+
+/* Prescaler value to write into ADPS2..0 (0..7) — use defined constants below */
+typedef uint8_t adc_prescaler_t;
+
+#define ADC_PRESCALER_2		1
+#define ADC_PRESCALER_4		2
+#define ADC_PRESCALER_8		3
+#define ADC_PRESCALER_16	4
+#define ADC_PRESCALER_32	5
+#define ADC_PRESCALER_64	6
+#define ADC_PRESCALER_128	7
+
+/* ADC clock divider of an ADPS value (0 and 1 both divide by 2) */
+#define ADC_DIV_OF(ps)			((ps) == 0 ? 2UL : (1UL << (ps)))
+
+/* Fastest ADPS value whose ADC clock does not exceed max_hz, from F_CPU */
+#define ADC_PRESCALER_FOR(max_hz)	( \
+	(F_CPU /   2UL) <= (max_hz) ? 1 : (F_CPU /  4UL) <= (max_hz) ? 2 : \
+	(F_CPU /   8UL) <= (max_hz) ? 3 : (F_CPU / 16UL) <= (max_hz) ? 4 : \
+	(F_CPU /  32UL) <= (max_hz) ? 5 : (F_CPU / 64UL) <= (max_hz) ? 6 : 7)
+
+/* Compile time prescalers (ADC_CLOCK_* in ADC_config.h):
+   10BIT  fastest clock inside the 50..200 kHz full accuracy window
+   8BIT   fastest clock up to ADC_FAST_CLOCK_MAX_HZ, 8-bit results only */
+#define ADC_PRESCALER_10BIT		ADC_PRESCALER_FOR(ADC_CLOCK_MAX_HZ)
+#define ADC_PRESCALER_8BIT		ADC_PRESCALER_FOR(ADC_FAST_CLOCK_MAX_HZ)
+
+/* Back-to-back (free running) conversions per second for an ADPS value */
+#define ADC_CLOCK_HZ(ps)		(F_CPU / ADC_DIV_OF(ps))
+#define ADC_SAMPLES_PER_SEC(ps)		(ADC_CLOCK_HZ(ps) / 13UL)
+#define ADC_SPS_10BIT			ADC_SAMPLES_PER_SEC(ADC_PRESCALER_10BIT)
+#define ADC_SPS_8BIT			ADC_SAMPLES_PER_SEC(ADC_PRESCALER_8BIT)
+
+
+/* Auto-trigger sources (ADTS2..0 in SFIOR) */
+typedef enum {
+	ADC_TRIG_FREE_RUNNING =0,
+	ADC_TRIG_ANALOG_COMP  =1,
+	ADC_TRIG_EXT_INT0     =2,
+	ADC_TRIG_TIMER0_COMP  =3,
+	ADC_TRIG_TIMER0_OVF   =4,
+	ADC_TRIG_TIMER1_COMPB =5,
+	ADC_TRIG_TIMER1_OVF   =6,
+	ADC_TRIG_TIMER1_CAPTURE =7
+}adc_trig_t;
+
+/* ADC channels (single ended) - values are MUX4..0 */
+typedef enum {
+    ADC_CH0 = 0,
+    ADC_CH1 = 1,
+    ADC_CH2 = 2,
+    ADC_CH3 = 3,
+    ADC_CH4 = 4,
+    ADC_CH5 = 5,
+    ADC_CH6 = 6,
+    ADC_CH7 = 7
+} adc_channel_t;
+
+typedef void (*adc_callback_t)(uint16_t adc_value);
+
+/* Channel plan: the final ADMUX byte (REFS1:0 | ADLAR | MUX4..0) for one
+   conversion, computed at compile time so that switching channels is a
+   single store. A left aligned entry means "8-bit result wanted".
+     static const adc_plan_t plan[] = {
+         ADC_PLAN(ADC_CH0, ADC_REF_AVCC, ADC_ALIGN_RIGHT),
+         ADC_PLAN(ADC_CH3, ADC_REF_INTERNAL_2V56, ADC_ALIGN_LEFT),
+     };
+*/
+typedef uint8_t adc_plan_t;
+
+#define ADC_PLAN_ADLAR		0x20
+#define ADC_PLAN(ch, ref, align)	((adc_plan_t)((uint8_t)(ref) | (((align) == ADC_ALIGN_LEFT) ? ADC_PLAN_ADLAR : 0) | ((uint8_t)(ch) & 0x1F)))
+#define ADC_PLAN_CHANNEL(p)	((adc_channel_t)((p) & 0x1F))
+#define ADC_PLAN_IS_8BIT(p)	(((p) & ADC_PLAN_ADLAR) != 0)
+
+/* Block capture events */
+typedef enum {
+	ADC_BLOCK_HALF	=1,	/* first half of the buffer being filled is ready */
+	ADC_BLOCK_FULL	=2	/* whole buffer ready, filling moved to the other one */
+}adc_block_evt_t;
+
+typedef void (*adc_block_callback_t)(adc_block_evt_t evt, const uint16_t *data, uint16_t len);
+
+/* Window comparator state of a channel */
+typedef enum {
+	ADC_WIN_OFF	=0,	/* no window set */
+	ADC_WIN_BELOW	=1,	/* result < low */
+	ADC_WIN_INSIDE	=2,	/* low <= result <= high */
+	ADC_WIN_ABOVE	=3	/* result > high */
+}adc_win_state_t;
+
+typedef void (*adc_window_callback_t)(adc_channel_t ch, adc_win_state_t state, uint16_t value);
+
+
+/* Configuration structure */
+
+typedef struct {
+	adc_ref_t	ref;			/* reference selection */
+	adc_align_t	align;			/* left/right adjust */
+	adc_prescaler_t	prescaler;		/* ADPS2..0 (0..7), normally ADC_PRESCALER_10BIT */
+	bool		auto_trigger;	 	/* ADATE */
+	adc_trig_t	trigger_src;		/* ADTS */
+	bool		interrupt_enable;	/* ADIE */
+	uint8_t		didr_mask;		/* bits to set in DIDR0 to disable digital inputs (bit i = ADCi) */
+	uint8_t		oversample_bits;	/* 0 = off, n = 1..3: ISR sums 4^n samples and shifts by n,
+						   scan/stream/sampling results become 10+n bits */
+	bool		fast8;			/* 8-bit conversions (ADC_read8, left aligned plans and
+						   scans made only of them) run at ADC_PRESCALER_8BIT */
+} ADC_Config_t;
+
+
+
+
+/* API */
+void ADC_init(const ADC_Config_t *cfg);
+void ADC_enable(void);
+void ADC_disable(void);
+uint16_t ADC_readBlocking(adc_channel_t ch); /* returns 0..1023 */
+uint8_t  ADC_read8(adc_channel_t ch);        /* returns 0..255 using left adjust */
+uint16_t ADC_readPlan(adc_plan_t plan);      /* 0..1023, or 0..255 for a left aligned plan */
+void     ADC_startConversion(adc_channel_t ch);
+bool     ADC_conversionInProgress(void);
+void     ADC_setAutoTrigger(adc_trig_t src, bool enable);
+void     ADC_setCallback(adc_callback_t cb); /* enable interrupt in config to use callback */
+/* Free running conversions per second with the current configuration,
+   for 10-bit or 8-bit (fast8) conversions */
+uint32_t ADC_samplesPerSecond(bool eight_bit);
+
+/* Scan engine (interrupt driven, see ADC_SCAN_* in ADC_config.h)
+   - ADC_scanStart copies the list, so it may live on the caller's stack.
+   - Results land in a per-channel table indexed by adc_channel_t; reading
+     it never blocks. ADC_scanRounds() increments after every full pass.
+   - While a scan is running do not call ADC_readBlocking/ADC_read8/
+     ADC_startConversion: they would steal conversions from the engine. */
+bool     ADC_scanStart(const adc_channel_t *channels, uint8_t n);
+void     ADC_scanStop(void);
+bool     ADC_scanBusy(void);
+uint16_t ADC_scanGetResult(adc_channel_t ch);
+uint8_t  ADC_scanRounds(void);
+/* Same engine driven by a precomputed plan (per-entry reference and width).
+   Entries must be single ended (ADC0..ADC7). */
+bool     ADC_scanStartPlan(const adc_plan_t *plan, uint8_t n);
+
+/* Streaming: free running conversions of one channel into the sample ring */
+bool     ADC_streamStart(adc_channel_t ch);
+void     ADC_streamStop(void);
+
+/* Timer paced sampling: the timer selected by ADC_SAMPLING_TIMER triggers
+   each conversion in hardware, so there is no sampling jitter and no CPU
+   work between samples. Samples go to the sample ring.
+   Returns the conversion rate actually achieved in Hz (rounded), 0 if rate_hz
+   cannot be reached with the current ADC prescaler or the timer range.
+   With oversample_bits = n the ring receives rate / 4^n results. */
+uint32_t ADC_startSampling(adc_channel_t ch, uint32_t rate_hz);
+void     ADC_stopSampling(void);
+
+/* Sample ring (single producer = ISR, single consumer = application)
+   ADC_ringAcquire() returns how many samples can be read in place starting
+   at *span (never wraps; call again after release to get the rest).
+   ADC_ringRelease() hands n of them back to the producer. */
+uint8_t  ADC_ringAcquire(const uint16_t **span);
+void     ADC_ringRelease(uint8_t n);
+uint8_t  ADC_ringAvailable(void);
+uint16_t ADC_ringOverruns(void);  /* samples dropped because the ring was full */
+uint8_t  ADC_ringHighWater(void); /* max fill level seen since last reset */
+void     ADC_ringResetStats(void);
+
+/* ADC Noise Reduction sleep conversions: the CPU sleeps for the whole
+   conversion (less digital noise, less current) and wakes on ADC_vect.
+   Needs global interrupts enabled; with them disabled the read falls back
+   to busy waiting. Returns 0 if an engine (scan/stream) owns the ADC.
+   Timer0/1 stop counting while the CPU sleeps. Timer2 interrupts enabled
+   with TIMER_enableInterrupts are held off during the conversion
+   (ADC_SLEEP_MASK_TIMER2). Any other wakeup before the result is counted
+   by ADC_sleepEarlyWakeups() and the conversion is repeated up to
+   ADC_SLEEP_RETRIES times. */
+uint16_t ADC_readSleep(adc_channel_t ch);
+uint16_t ADC_readSleepPlan(adc_plan_t plan);
+bool     ADC_scanSleep(const adc_plan_t *plan, uint8_t n, uint16_t *out);
+uint16_t ADC_sleepEarlyWakeups(void);
+
+/* Ping-pong block capture: routes streamed/sampled results into two
+   application buffers of len samples (len even) instead of the ring.
+   The ISR fills one buffer while the application works on the other.
+   cb (may be 0) runs from the ISR once at half and once at full buffer,
+   never per sample. Polling alternative: ADC_blockGet() returns the last
+   full buffer until ADC_blockRelease(). A buffer that completes while the
+   previous one is still held counts as an overrun.
+   Call before ADC_streamStart()/ADC_startSampling(). */
+bool     ADC_blockStart(uint16_t *buf0, uint16_t *buf1, uint16_t len, adc_block_callback_t cb);
+void     ADC_blockStop(void);
+const uint16_t *ADC_blockGet(uint16_t *len);
+void     ADC_blockRelease(void);
+uint16_t ADC_blockOverruns(void);
+
+/* Window comparator, evaluated in ISR(ADC_vect) on every scan, stream and
+   single (ADC_startConversion) result of ADC0..ADC7, after oversampling
+   and ADC_ISR_FILTER, in the units of that result. Nothing is reported
+   while the state does not change; a change sets the channel's bit for
+   ADC_windowEvents() and calls the callback (from the ISR, may be 0).
+   Hysteresis: once inside, a result must fall below low - hyst or rise
+   above high + hyst to leave; re-entering needs low / high themselves.
+   The first result after ADC_windowSet() always reports its state.
+   Cost per result with no transition: two 16-bit compares. */
+bool     ADC_windowSet(adc_channel_t ch, uint16_t low, uint16_t high, uint16_t hyst);
+void     ADC_windowDisable(adc_channel_t ch);
+void     ADC_windowSetCallback(adc_window_callback_t cb);
+adc_win_state_t ADC_windowState(adc_channel_t ch);
+uint8_t  ADC_windowEvents(void);  /* bit i = ADCi changed state since the last call (cleared) */
+
+
+#endif /* ADC_INTERFACE_H */
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
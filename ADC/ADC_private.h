@@ -1,14 +1,73 @@
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_private.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-//Layer: MCAL
-//SWC  : ADC
-
-
-
-
-
-#ifndef _DIO_PRIVATE_H_
-#define	_DIO_PRIVATE_H_
-
-
-
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_private.h   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC
+
+
+
+
+
+#ifndef _ADC_PRIVATE_H_
+#define	_ADC_PRIVATE_H_
+
+
+/* What ISR(ADC_vect) does with a finished conversion */
+typedef enum {
+	ADC_MODE_IDLE	=0,	/* single conversions: hand result to adc_callback_t */
+	ADC_MODE_SCAN	,	/* pipelined scan engine owns the converter */
+	ADC_MODE_STREAM	,	/* free running single channel into the sample ring */
+	ADC_MODE_SLEEP		/* one conversion started by ADC Noise Reduction sleep */
+}adc_mode_t;
+
+/* ADMUX MUX4..0 field */
+#define ADC_MUX_MASK		0x1F
+
+/* Result table covers the single ended channels ADC0..ADC7 */
+#define ADC_NUM_CHANNELS	8
+
+/* Free running trigger source in ADTS2..0 */
+#define ADC_SFIOR_ADTS_MASK	0xE0
+#define ADC_SFIOR_ADTS_SHIFT	5
+
+/* Conversion length in ADC clocks (normal conversion, not the first one) */
+#define ADC_CONV_CLOCKS		13
+
+/* Oversampling: 4^3 * 1023 still fits the 16-bit accumulator */
+#define ADC_OVERSAMPLE_MAX_BITS	3
+
+/* Sample ring (size comes from ADC_config.h) */
+#define ADC_RING_MASK		(ADC_RING_SIZE - 1)
+
+/* Window comparator of one channel. The ISR only tests
+   thr_lo <= v <= thr_hi, the band in which the current state cannot
+   change; leaving it takes the slow path that reclassifies. */
+typedef struct {
+	uint16_t low, high, hyst;
+	uint16_t thr_lo, thr_hi;
+	adc_win_state_t state;
+} adc_window_t;
+
+/* MUX4..0 of the internal 1.22 V bandgap */
+#define ADC_MUX_BANDGAP		0x1E
+
+/* Calibration of one channel: k = Vref * gain, in the form the
+   conversion multiplies with (see ADC_calib_program.c) */
+typedef struct {
+	int16_t  offset;	/* counts */
+	uint16_t gain_q14;
+	uint16_t k;
+} adc_calib_ch_t;
+
+/* Keeps the compiler from moving buffer accesses across an index update.
+   Single core AVR needs nothing more for SPSC ordering. */
+#define ADC_COMPILER_BARRIER()	__asm__ __volatile__("" ::: "memory")
+
+/* Body of a loop that waits for ISR(ADC_vect) to set a RAM flag. Nothing
+   on the chip; a host model whose clock only moves on register accesses
+   binds it from the build (SIM: ADC_POLL_HOOK()=SIM_idle()). */
+#ifndef ADC_POLL_HOOK
+#define ADC_POLL_HOOK()
+#endif
+
+
+
 #endif			
\ No newline at end of file
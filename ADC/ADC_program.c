@@ -1,188 +1,858 @@
-//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_program.c   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
-//Layer: MCAL
-//SWC  : ADC
-
-
-
-
-
-
-#include "ADC_interface.h"
-#include "ADC_private.h"
-#include "ADC_config.h"
-#include <avr/io.h>
-#include <avr/interrupt.h> /* for ISR macro */
-#include <avr/power.h>     /* optional: power_adc_enable()/disable() */
-#include <util/delay.h>    /* optional small delays */
-
-
-static volatile adc_callback_t adc_cb	=0;
-static adc_prescaler_t saved_prescaler	=0;
-
-
-/* low-level helper: select channel (preserve REFS/ADLAR bits in ADMUX) */
-static inline void adc_select_channel(adc_channel_t ch){
-	ADMUX =(ADMUX&0xE0)|((uint8_t)ch & 0x1F);
-}
- 
-
-/* read full 10-bit result (safe order). Assumes ADLAR==0 for 10-bit read.
-   If ADLAR==1 and you want full 10-bit, you'd need to combine differently.
-*/
-
-
-static inline uint16_t adc_get_result_raw(void) {
-	/* When reading 16-bit result split across ADCL/ADCH: read ADCL first, then ADCH */ 
-	uint16_t val=ADCL;
-	val |=((uint16_t)ADCH<<8;
-	return val;
-}
-
-
-void ADC_init (const ADC_config_t *cfg) {
-	if (!cfg)return;
-	 /* Make sure ADC power reduction bit is clear (PRADC = 0) */
-#if defined(PRR)
-    PRR &= ~(1<<PRADC); /* enable ADC power domain */
-#endif
- 	/* configure ADMUX: reference and alignment */
-	ADMUX =(uint8_t)cfg->ref; /* places bits REFS1:0 in bits7:6 */
-	if (cfg->align==ADC_ALIGN_LEFT) ADMUX |=(1<<ADLAR);
-	else ADMUX &=~(1<<ADLAR);
-	adc_select_channel(ADC_CH0);
-	saved_prescaler =cfg->prescaler &0x07;
-	ADCSRA =(ADCSRA & ~0x07)|(saved_prescaler & 0x07);
-	
-	
-	/*auto trigger*/
-	if (cfg->interrupt_enable) ADCSRA|=(1<<ADIE);
-	else ADCSRA&=~(1<<ADIE);
-	
-
-	 /* set trigger source in SFIOR (ADTS2:0 are bits 7..5) */	
-	SFIOR =(SFIOR&~(0xE0)) |((uint8_t)(cfg->trigger_src & 0x07)<<5);
-	
-	
-	/* configure DIDR0 to disable digital inputs on ADC pins if requested */
-	#if defined (DIDR0)
-		DIDR0 |=cfg->didr_mask;
-	#endif
-
-	/* Finally enable ADC */
-	 ADCSRA |= (1<<ADEN);
-}
-
-void ADC_enable(void){
-	#if defined(PRR)
-		PRR&=~(1<<PRADC);
-	#endif
-	ADCSRA|=(1<<ADEN);
-}
-void ADC_disable(void){
-	ADCSRA&=~(1<<ADEN);
-	#if defined(PRR)
-		PRR|=(1<<PRADC);
-	#endif
-}
-
-uint16_t ADC_readBlocking(adc_channel_t ch) {
-	 /* Select channel (safe updating: ADMUX is double-buffered; conversion locks values) */
-	adc_select_channel(ch);
-	
-
-	/*start conversion*/
-	ADCSRA|=(1<<ADSC);
-	
-	/* wait until ADSC cleared (conversion finished) */
-	while (ADCSRA & (1<<ADSC)) { }
-
-
-
-	/* ADCL must be read first (see datasheet) */
-	return adc_get_result_raw() & 0x03FF;
-}
-
-/* Convenience 8-bit read (left adjusted -> ADCH contains the top 8 bits) */
-uint8_t ADC_read8(adc_channel_t ch) {
-	/*set ADLAR =1 */
-	ADMUX |= (1<<ADLAR);
-	adc_select_channel(ch);
-	
-	/* start and wait */	
-	 ADCSRA |= (1<<ADSC);
-	while(ADCSRA & (1<<ADSC)){}
-
-	/* when left-adjusted, ADCH contains the top 8 bits — read ADCH */
-   	 return ADCH;
-}
-
-
-/* Start conversion (do not wait) */
-void ADC_startConversion(adc_channel_t ch) {
-    adc_select_channel(ch);
-    ADCSRA |= (1<<ADSC);
-}
-
-
-
-bool ADC_conversionInProgress(void) {
-    return (ADCSRA & (1<<ADSC)) != 0;
-}
-
-
-void ADC_setAutoTrigger(adc_trigger_t src, bool enable) {
-    /* write ADTS bits into SFIOR[7:5] */
-    SFIOR = (SFIOR & ~(0xE0)) | ((uint8_t)(src & 0x07) << 5);
-    if (enable) ADCSRA |= (1<<ADATE);
-    else ADCSRA &= ~(1<<ADATE);
-}
-
-
-
-void ADC_setCallback(adc_callback_t cb) {
-    adc_cb = cb;
-}
-
-
-/* ISR for ADC Conversion Complete - call user callback if set */
-ISR(ADC_vect) {
-    uint16_t v = adc_get_result_raw() & 0x03FF;
-    if (adc_cb) adc_cb(v);
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  ADC_program.c   <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+//Layer: MCAL
+//SWC  : ADC
+
+
+
+
+
+
+#include "ADC_interface.h"
+#include "ADC_private.h"
+#include "ADC_config.h"
+#include "ADC_filter_interface.h"	/* for filters bound through ADC_ISR_FILTER */
+#include "TIMER_interface.h"
+#include <avr/io.h>
+#include <avr/interrupt.h> /* for ISR macro */
+#include <avr/power.h>     /* optional: power_adc_enable()/disable() */
+#include <avr/sleep.h>     /* ADC Noise Reduction mode */
+#include <util/delay.h>    /* optional small delays */
+#include <util/atomic.h>   /* ATOMIC_BLOCK for 16-bit shared results */
+
+
+#if (ADC_RING_SIZE & (ADC_RING_SIZE - 1)) || (ADC_RING_SIZE > 128) || (ADC_RING_SIZE < 2)
+#error "ADC_RING_SIZE must be a power of two between 2 and 128"
+#endif
+
+#if ADC_CLOCK_HZ(ADC_PRESCALER_10BIT) < ADC_CLOCK_MIN_HZ
+#warning "F_CPU too low: no prescaler reaches the 50..200 kHz ADC clock window"
+#endif
+#if ADC_CLOCK_HZ(ADC_PRESCALER_10BIT) > ADC_CLOCK_MAX_HZ
+#warning "F_CPU too high: /128 still exceeds the 10-bit ADC clock window"
+#endif
+
+
+static volatile adc_callback_t adc_cb	=0;
+static adc_prescaler_t saved_prescaler	=0;	/* 10-bit conversions */
+static adc_prescaler_t adc_ps8		=0;	/* 8-bit conversions (fast8) */
+static adc_prescaler_t adc_ps_now	=0;	/* ADPS currently in ADCSRA */
+static bool saved_irq_enable		=0;
+
+/* ADMUX bytes without MUX bits, fixed at ADC_init: per-call reads become one store */
+static uint8_t adc_admux_cfg		=0;	/* configured reference + alignment */
+static uint8_t adc_admux_right		=0;	/* configured reference, ADLAR = 0 */
+static volatile adc_mode_t adc_mode	=ADC_MODE_IDLE;
+
+/* scan engine state: written by ADC_scanStart, then owned by the ISR */
+static adc_plan_t adc_scan_list[ADC_SCAN_MAX_CHANNELS];
+static uint8_t adc_scan_len		=0;
+static uint8_t adc_scan_done		=0;	/* list index of the conversion that just finished */
+static uint8_t adc_scan_running		=0;	/* list index latched by the conversion in progress */
+#if ADC_SCAN_CONTINUOUS == 0
+static uint8_t adc_scan_remaining	=0;	/* results still expected in one-shot mode */
+#endif
+static volatile uint16_t adc_scan_result[ADC_NUM_CHANNELS];
+static volatile uint8_t  adc_scan_rounds	=0;
+
+/* plan converted by the stream/sampling engine */
+static adc_plan_t adc_stream_plan	=0;
+
+/* sample ring: head written only by the ISR, tail only by the consumer */
+static uint16_t adc_ring_buf[ADC_RING_SIZE];
+static volatile uint8_t  adc_ring_head	=0;
+static volatile uint8_t  adc_ring_tail	=0;
+static volatile uint8_t  adc_ring_hwm	=0;
+static volatile uint16_t adc_ring_overruns	=0;
+
+/* ping-pong block capture (adc_block_len == 0: results go to the ring) */
+static uint16_t *adc_block_buf[2];
+static uint16_t *adc_block_fill		=0;	/* buffer the ISR writes */
+static uint16_t * volatile adc_block_ready =0;	/* last full buffer not yet released */
+static uint16_t adc_block_len		=0;
+static uint16_t adc_block_idx		=0;
+static volatile adc_block_callback_t adc_block_cb =0;
+static volatile uint16_t adc_block_overruns	=0;
+
+/* noise reduction sleep: result handed over by the ISR */
+static volatile bool	 adc_sleep_done		=0;
+static volatile uint16_t adc_sleep_result	=0;
+static uint16_t adc_sleep_early			=0;	/* main context only */
+
+/* oversampling / decimation (0 = off) */
+static uint8_t  adc_os_bits		=0;
+static uint16_t adc_stream_acc		=0;
+static uint8_t  adc_stream_cnt		=0;
+static uint16_t adc_scan_acc[ADC_SCAN_MAX_CHANNELS];
+static uint8_t  adc_scan_cnt[ADC_SCAN_MAX_CHANNELS];
+
+/* window comparator: an unset window has a band that nothing leaves */
+#if ADC_WINDOW_ENABLE
+static adc_window_t adc_win[ADC_NUM_CHANNELS] ={
+	[0 ... ADC_NUM_CHANNELS - 1] ={ .thr_lo =0, .thr_hi =0xFFFF, .state =ADC_WIN_OFF }
+};
+static volatile uint8_t adc_win_events	=0;
+static volatile adc_window_callback_t adc_win_cb =0;
+#endif
+
+/* timer paced sampling: TIFR flag that must be cleared to re-arm the trigger */
+static uint8_t adc_trig_flag		=0;
+
+/* ADTS (SFIOR) and ADATE as ADC_init left them, put back when an engine stops */
+static uint8_t adc_saved_adts		=0;
+static uint8_t adc_saved_adate		=0;
+
+/* Timer0/Timer1 prescaler divisors, index = TIMER01_Clock_t - TIMER01_CLK_1 */
+static const uint16_t adc_timer_div[] = { 1, 8, 64, 256, 1024 };
+
+
+/* low-level helper: the channel plan is the whole ADMUX byte, one store */
+static inline void adc_select_plan(adc_plan_t plan){
+	ADMUX =plan;
+}
+
+static inline adc_plan_t adc_plan_of(adc_channel_t ch){
+	return (adc_plan_t)(adc_admux_cfg | ((uint8_t)ch & ADC_MUX_MASK));
+}
+
+/* ADC clock for a plan: 8-bit plans may run faster (fast8). Only called
+   with the converter idle; ADIF is written 0 so a pending result stays. */
+static inline adc_prescaler_t adc_ps_of(adc_plan_t plan){
+	return ADC_PLAN_IS_8BIT(plan) ? adc_ps8 : saved_prescaler;
+}
+
+static inline void adc_set_clock(adc_prescaler_t ps){
+	if (ps != adc_ps_now) {
+		ADCSRA =(ADCSRA & ~((1<<ADIF) | 0x07)) | ps;
+		adc_ps_now =ps;
+	}
+}
+
+
+static inline uint16_t adc_get_result_raw(void) {
+	/* When reading 16-bit result split across ADCL/ADCH: read ADCL first, then ADCH */ 
+	uint16_t val=ADCL;
+	val |=((uint16_t)ADCH<<8);
+	return val;
+}
+
+/* result as 0..1023 whatever ADLAR currently says. ADLAR changes the
+   presentation immediately, so in the scan engine this must run before
+   ADMUX is rewritten for the next entry. */
+static inline uint16_t adc_get_result10(void) {
+	uint16_t val =adc_get_result_raw();
+	if (ADMUX & (1<<ADLAR)) val >>=6;
+	return val & 0x03FF;
+}
+
+
+/* ADMUX and ADCSRA are each written once, ADCSRA last: the trigger source
+   and the digital input buffers are set before the converter is enabled,
+   and the prescaler, interrupt enable and ADEN arrive together. */
+void ADC_init (const ADC_Config_t *cfg) {
+	uint8_t sra;
+
+	if (!cfg)return;
+	 /* Make sure ADC power reduction bit is clear (PRADC = 0) */
+#if defined(PRR)
+    PRR &= ~(1<<PRADC); /* enable ADC power domain */
+#endif
+ 	/* configure ADMUX: reference and alignment, one store */
+	adc_admux_right =(uint8_t)cfg->ref; /* places bits REFS1:0 in bits7:6 */
+	adc_admux_cfg	=ADC_PLAN(0, cfg->ref, cfg->align);
+	adc_select_plan(adc_plan_of(ADC_CH0));
+	saved_prescaler =cfg->prescaler &0x07;
+	/* fast8 never slows a prescaler that is already faster */
+	adc_ps8 =(cfg->fast8 && ADC_DIV_OF(ADC_PRESCALER_8BIT) < ADC_DIV_OF(saved_prescaler)) ? ADC_PRESCALER_8BIT : saved_prescaler;
+	adc_ps_now =saved_prescaler;
+	adc_os_bits =(cfg->oversample_bits > ADC_OVERSAMPLE_MAX_BITS) ? ADC_OVERSAMPLE_MAX_BITS : cfg->oversample_bits;
+	saved_irq_enable =cfg->interrupt_enable;
+
+	 /* set trigger source in SFIOR (ADTS2:0 are bits 7..5) */	
+	SFIOR =(SFIOR&~(0xE0)) |((uint8_t)(cfg->trigger_src & 0x07)<<5);
+
+	/* configure DIDR0 to disable digital inputs on ADC pins if requested */
+	#if defined (DIDR0)
+		DIDR0 |=cfg->didr_mask;
+	#endif
+
+	/* ADATE kept; ADSC written 0 (no start); a stale ADIF is cleared */
+	sra =(uint8_t)(ADCSRA & ~((1<<ADSC) | (1<<ADIE) | 0x07));
+	sra |=(uint8_t)((1<<ADEN) | (1<<ADIF) | saved_prescaler);
+	if (cfg->interrupt_enable) sra |=(1<<ADIE);
+	ADCSRA =sra;
+}
+
+void ADC_enable(void){
+	#if defined(PRR)
+		PRR&=~(1<<PRADC);
+	#endif
+	ADCSRA|=(1<<ADEN);
+}
+void ADC_disable(void){
+	ADCSRA&=~(1<<ADEN);
+	#if defined(PRR)
+		PRR|=(1<<PRADC);
+	#endif
+}
+
+uint16_t ADC_readBlocking(adc_channel_t ch) {
+	 /* Select channel with ADLAR=0 (safe updating: ADMUX is double-buffered; conversion locks values) */
+	adc_select_plan((adc_plan_t)(adc_admux_right | ((uint8_t)ch & ADC_MUX_MASK)));
+	adc_set_clock(saved_prescaler);
+
+	/*start conversion*/
+	ADCSRA|=(1<<ADSC);
+	
+	/* wait until ADSC cleared (conversion finished) */
+	while (ADCSRA & (1<<ADSC)) { }
+
+
+
+	/* ADCL must be read first (see datasheet) */
+	return adc_get_result_raw() & 0x03FF;
+}
+
+/* Convenience 8-bit read (left adjusted -> ADCH contains the top 8 bits).
+   ADLAR is part of this call's ADMUX byte only, so a following
+   ADC_readBlocking() is not affected. */
+uint8_t ADC_read8(adc_channel_t ch) {
+	adc_select_plan((adc_plan_t)(adc_admux_right | ADC_PLAN_ADLAR | ((uint8_t)ch & ADC_MUX_MASK)));
+	adc_set_clock(adc_ps8);
+
+	/* start and wait */	
+	 ADCSRA |= (1<<ADSC);
+	while(ADCSRA & (1<<ADSC)){}
+
+	/* when left-adjusted, ADCH contains the top 8 bits — read ADCH */
+   	 return ADCH;
+}
+
+uint16_t ADC_readPlan(adc_plan_t plan) {
+	adc_select_plan(plan);
+	adc_set_clock(adc_ps_of(plan));
+	ADCSRA |= (1<<ADSC);
+	while (ADCSRA & (1<<ADSC)) { }
+	if (ADC_PLAN_IS_8BIT(plan)) return ADCH;
+	return adc_get_result_raw() & 0x03FF;
+}
+
+
+/* Start conversion (do not wait) */
+void ADC_startConversion(adc_channel_t ch) {
+    adc_select_plan(adc_plan_of(ch));
+    adc_set_clock(saved_prescaler);	/* callers may read all 10 bits */
+    ADCSRA |= (1<<ADSC);
+}
+
+
+
+uint32_t ADC_samplesPerSecond(bool eight_bit) {
+	return F_CPU / (ADC_DIV_OF(eight_bit ? adc_ps8 : saved_prescaler) * ADC_CONV_CLOCKS);
+}
+
+
+bool ADC_conversionInProgress(void) {
+    return (ADCSRA & (1<<ADSC)) != 0;
+}
+
+
+void ADC_setAutoTrigger(adc_trig_t src, bool enable) {
+    /* write ADTS bits into SFIOR[7:5] */
+    SFIOR = (SFIOR & ~(0xE0)) | ((uint8_t)(src & 0x07) << 5);
+    if (enable) ADCSRA |= (1<<ADATE);
+    else ADCSRA &= ~(1<<ADATE);
+}
+
+
+
+void ADC_setCallback(adc_callback_t cb) {
+    adc_cb = cb;
+}
+
+
+/* ===================== Oversampling ===================== */
+/*
+   Accumulate-and-decimate: 4^n consecutive samples are summed and the sum
+   is shifted right by n, giving n extra bits (needs about 1 LSB of noise on
+   the input to work). Runs inside the ISR: one add and one decrement per
+   sample, a shift once per window.
+*/
+
+/* samples per decimation window */
+static inline uint8_t adc_os_window(void) {
+	return (uint8_t)(1u << (2 * adc_os_bits));
+}
+
+/* feed *v; returns true with the decimated value in *v when a window closes */
+static inline bool adc_os_step(uint16_t *acc, uint8_t *cnt, uint16_t *v) {
+	if (adc_os_bits == 0) return true;
+	*acc += *v;
+	if (--(*cnt)) return false;
+	*v	=*acc >> adc_os_bits;
+	*acc	=0;
+	*cnt	=adc_os_window();
+	return true;
+}
+
+
+/* ===================== Window comparator ===================== */
+#if ADC_WINDOW_ENABLE
+
+/* band of results that keeps state st */
+static void adc_window_band(adc_window_t *w, adc_win_state_t st) {
+	w->state =st;
+	switch (st) {
+	case ADC_WIN_BELOW:
+		w->thr_lo =0;
+		w->thr_hi =w->low - 1;		/* low > 0 here: nothing is below 0 */
+		break;
+	case ADC_WIN_ABOVE:
+		w->thr_lo =w->high + 1;		/* high < 0xFFFF here */
+		w->thr_hi =0xFFFF;
+		break;
+	case ADC_WIN_INSIDE: {
+		uint16_t room =0xFFFF - w->high;
+		w->thr_lo =(w->low > w->hyst) ? (uint16_t)(w->low - w->hyst) : 0;
+		w->thr_hi =(w->hyst < room) ? (uint16_t)(w->high + w->hyst) : 0xFFFF;
+	} break;
+	default:
+		w->thr_lo =0;
+		w->thr_hi =0xFFFF;
+		break;
+	}
+}
+
+/* slow path, v left the band: thresholds already hold the hysteresis,
+   so plain low/high decide the new state */
+static void adc_window_move(uint8_t ch, adc_window_t *w, uint16_t v) {
+	adc_win_state_t st;
+	adc_window_callback_t cb;
+
+	if (v < w->low)		st =ADC_WIN_BELOW;
+	else if (v > w->high)	st =ADC_WIN_ABOVE;
+	else			st =ADC_WIN_INSIDE;
+
+	adc_window_band(w, st);
+	adc_win_events |=(uint8_t)(1 << ch);
+	cb =adc_win_cb;
+	if (cb) cb((adc_channel_t)ch, st, v);
+}
+
+bool ADC_windowSet(adc_channel_t ch, uint16_t low, uint16_t high, uint16_t hyst) {
+	adc_window_t *w;
+
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS || low > high) return false;
+	w =&adc_win[ch];
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		w->low	=low;
+		w->high	=high;
+		w->hyst	=hyst;
+		/* empty band: the next result classifies and reports */
+		w->state =ADC_WIN_OFF;
+		w->thr_lo =0xFFFF;
+		w->thr_hi =0;
+		adc_win_events &=(uint8_t)~(1 << ch);
+	}
+	return true;
+}
+
+void ADC_windowDisable(adc_channel_t ch) {
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS) return;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		adc_window_band(&adc_win[ch], ADC_WIN_OFF);
+		adc_win_events &=(uint8_t)~(1 << ch);
+	}
+}
+
+void ADC_windowSetCallback(adc_window_callback_t cb) {
+	adc_win_cb =cb;
+}
+
+adc_win_state_t ADC_windowState(adc_channel_t ch) {
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS) return ADC_WIN_OFF;
+	return adc_win[ch].state;
+}
+
+uint8_t ADC_windowEvents(void) {
+	uint8_t ev;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ev =adc_win_events;
+		adc_win_events =0;
+	}
+	return ev;
+}
+
+#endif /* ADC_WINDOW_ENABLE */
+
+/* ISR only, ch < ADC_NUM_CHANNELS */
+static inline void adc_window_check(uint8_t ch, uint16_t v) {
+#if ADC_WINDOW_ENABLE
+	adc_window_t *w =&adc_win[ch];
+	if (v < w->thr_lo || v > w->thr_hi) adc_window_move(ch, w, v);
+#else
+	(void)ch; (void)v;
+#endif
+}
+
+
+/* ===================== Scan engine ===================== */
+/*
+   The converter runs in free-running mode for the whole scan. ADMUX is
+   latched when a conversion starts, so by the time the ISR reports result k
+   conversion k+1 is already running on the channel written one ISR earlier.
+   The ISR therefore only has to queue channel k+2: back-to-back conversions
+   never wait for a channel switch.
+
+   The very first conversion after ADSC starts before the ISR can queue the
+   second entry, so the first entry is converted twice. That costs one
+   conversion per ADC_scanStart() and nothing afterwards.
+*/
+
+/* auto triggered conversions of plan from src; caller has set adc_mode */
+static void adc_engine_start(adc_plan_t plan, adc_trig_t src) {
+	adc_saved_adts	=SFIOR & ADC_SFIOR_ADTS_MASK;
+	adc_saved_adate	=ADCSRA & (1<<ADATE);
+	SFIOR =(SFIOR & ~ADC_SFIOR_ADTS_MASK) | ((uint8_t)src << ADC_SFIOR_ADTS_SHIFT);
+	adc_select_plan(plan);
+
+	/* writing ADIF=1 drops any stale completion before ADIE is set */
+	ADCSRA |= (1<<ADIF)|(1<<ADIE)|(1<<ADATE);
+
+	/* free running needs a first conversion, other sources start on their own */
+	if (src == ADC_TRIG_FREE_RUNNING) ADCSRA |= (1<<ADSC);
+}
+
+bool ADC_scanStart(const adc_channel_t *channels, uint8_t n) {
+	adc_plan_t plan[ADC_SCAN_MAX_CHANNELS];
+	uint8_t i;
+
+	if (!channels || n == 0 || n > ADC_SCAN_MAX_CHANNELS) return false;
+	for (i = 0; i < n; i++) plan[i] =adc_plan_of(channels[i]);
+	return ADC_scanStartPlan(plan, n);
+}
+
+bool ADC_scanStartPlan(const adc_plan_t *plan, uint8_t n) {
+	uint8_t all8 =ADC_PLAN_ADLAR;
+	uint8_t i;
+
+	if (!plan || n == 0 || n > ADC_SCAN_MAX_CHANNELS) return false;
+	if (adc_mode != ADC_MODE_IDLE) return false;
+	for (i = 0; i < n; i++) {
+		if ((uint8_t)ADC_PLAN_CHANNEL(plan[i]) >= ADC_NUM_CHANNELS) return false;
+		adc_scan_list[i] = plan[i];
+		all8		&=plan[i];
+		adc_scan_acc[i]	 =0;
+		adc_scan_cnt[i]	 =adc_os_window();
+	}
+
+	adc_scan_len		=n;
+	adc_scan_done		=0;
+	adc_scan_running	=0;
+#if ADC_SCAN_CONTINUOUS == 0
+	adc_scan_remaining	=n + 1;	/* +1 for the duplicated first entry */
+#endif
+	adc_mode		=ADC_MODE_SCAN;
+
+	/* one clock for the whole free running scan: fast only if every entry is 8-bit */
+	adc_set_clock(all8 ? adc_ps8 : saved_prescaler);
+	adc_engine_start(adc_scan_list[0], ADC_TRIG_FREE_RUNNING);
+	return true;
+}
+
+/* the converter is idle: back to the trigger configured by ADC_init */
+static inline void adc_engine_restore(void) {
+	SFIOR =(SFIOR & ~ADC_SFIOR_ADTS_MASK) | adc_saved_adts;
+	ADCSRA |=adc_saved_adate;
+}
+
+/* stop whichever free running engine owns the converter */
+static void adc_engine_stop(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		ADCSRA &= ~(1<<ADATE);	/* no new conversions after the running one */
+		adc_mode =ADC_MODE_IDLE;
+	}
+	/* let the running conversion finish, then drop its completion flag */
+	while (ADCSRA & (1<<ADSC)) { }
+	ADCSRA |= (1<<ADIF);
+	if (!saved_irq_enable) ADCSRA &= ~(1<<ADIE);
+	adc_engine_restore();
+}
+
+void ADC_scanStop(void) {
+	if (adc_mode == ADC_MODE_SCAN) adc_engine_stop();
+}
+
+bool ADC_scanBusy(void) {
+	return adc_mode == ADC_MODE_SCAN;
+}
+
+uint16_t ADC_scanGetResult(adc_channel_t ch) {
+	uint16_t v;
+	if ((uint8_t)ch >= ADC_NUM_CHANNELS) return 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		v =adc_scan_result[ch];
+	}
+	return v;
+}
+
+uint8_t ADC_scanRounds(void) {
+	return adc_scan_rounds;
+}
+
+static inline void adc_scan_isr(uint16_t v) {
+	uint8_t done =adc_scan_done;
+	uint8_t next =adc_scan_running + 1;
+
+	if (next == adc_scan_len) next =0;
+
+	/* queue the entry for the conversion after the running one */
+	adc_select_plan(adc_scan_list[next]);
+
+	if (ADC_PLAN_IS_8BIT(adc_scan_list[done])) v >>=2;
+	if (adc_os_step(&adc_scan_acc[done], &adc_scan_cnt[done], &v)) {
+		uint8_t ch =ADC_PLAN_CHANNEL(adc_scan_list[done]);
+		v =ADC_ISR_FILTER(ch, v);
+		adc_scan_result[ch] =v;
+		adc_window_check(ch, v);
+		if (done == adc_scan_len - 1) adc_scan_rounds++;
+	}
+
+	adc_scan_done	=adc_scan_running;
+	adc_scan_running=next;
+
+#if ADC_SCAN_CONTINUOUS == 0
+	if (--adc_scan_remaining == 1) {
+		/* the running conversion is the last one we need */
+		ADCSRA &= ~(1<<ADATE);
+	} else if (adc_scan_remaining == 0) {
+		adc_mode =ADC_MODE_IDLE;
+		if (!saved_irq_enable) ADCSRA &= ~(1<<ADIE);
+		adc_engine_restore();
+	}
+#endif
+}
+
+
+/* ===================== Streaming / sample ring ===================== */
+
+bool ADC_streamStart(adc_channel_t ch) {
+	if ((uint8_t)ch > ADC_MUX_MASK) return false;
+	if (adc_mode != ADC_MODE_IDLE) return false;
+	adc_mode =ADC_MODE_STREAM;
+	adc_stream_plan =adc_plan_of(ch);
+	adc_trig_flag =0;
+	adc_stream_acc =0;
+	adc_stream_cnt =adc_os_window();
+	adc_set_clock(adc_ps_of(adc_stream_plan));
+	adc_engine_start(adc_stream_plan, ADC_TRIG_FREE_RUNNING);
+	return true;
+}
+
+void ADC_streamStop(void) {
+	if (adc_mode != ADC_MODE_STREAM) return;
+	if (adc_trig_flag) TIMER_stop(ADC_SAMPLING_TIMER);
+	adc_engine_stop();
+	adc_trig_flag =0;
+}
+
+/* ===================== Timer paced sampling ===================== */
+
+uint32_t ADC_startSampling(adc_channel_t ch, uint32_t rate_hz) {
+	const uint32_t top_max =(ADC_SAMPLING_TIMER == TIMER_ID_1) ? 0xFFFFUL : 0xFFUL;
+	adc_prescaler_t ps	=adc_ps_of(adc_plan_of(ch));
+	uint32_t adc_div	=ADC_DIV_OF(ps);
+	uint32_t best_err	=0xFFFFFFFFUL;
+	uint32_t best_hz	=0;
+	uint16_t best_top	=0;
+	uint8_t  best_clk	=TIMER01_CLK_OFF;
+	uint8_t  i;
+	TIMER_Config_t t = {0};
+
+	if ((uint8_t)ch > ADC_MUX_MASK || rate_hz == 0) return 0;
+	if (adc_mode != ADC_MODE_IDLE) return 0;
+
+	/* one conversion must fit in a sample period */
+	if (rate_hz > F_CPU / (adc_div * ADC_CONV_CLOCKS)) return 0;
+
+	/* CTC period = div * (TOP + 1): try every prescaler, keep the closest rate.
+	   Ties go to the smaller prescaler (finer steps for later retuning). */
+	for (i = 0; i < sizeof(adc_timer_div) / sizeof(adc_timer_div[0]); i++) {
+		uint32_t step	=(uint32_t)adc_timer_div[i] * rate_hz;
+		uint32_t counts	=(F_CPU + step / 2) / step;
+		uint32_t hz, err;
+
+		if (counts == 0 || counts - 1 > top_max) continue;
+		hz  =(F_CPU + ((uint32_t)adc_timer_div[i] * counts) / 2) / ((uint32_t)adc_timer_div[i] * counts);
+		err =(hz > rate_hz) ? hz - rate_hz : rate_hz - hz;
+		if (err < best_err) {
+			best_err =err;
+			best_hz  =hz;
+			best_top =(uint16_t)(counts - 1);
+			best_clk =TIMER01_CLK_1 + i;
+		}
+	}
+	if (best_clk == TIMER01_CLK_OFF) return 0;
+
+	/* ADC first, so the first compare match already finds it armed */
+	adc_mode =ADC_MODE_STREAM;
+	adc_stream_plan =adc_plan_of(ch);
+	adc_stream_acc =0;
+	adc_stream_cnt =adc_os_window();
+	adc_set_clock(ps);
+	if (ADC_SAMPLING_TIMER == TIMER_ID_1) {
+		adc_trig_flag =(1<<OCF1B);
+		TIFR =adc_trig_flag;
+		adc_engine_start(adc_stream_plan, ADC_TRIG_TIMER1_COMPB);
+	} else {
+		adc_trig_flag =(1<<OCF0);
+		TIFR =adc_trig_flag;
+		adc_engine_start(adc_stream_plan, ADC_TRIG_TIMER0_COMP);
+	}
+
+	/* CTC with TOP in OCR0/OCR1A; on Timer1 OCR1B = TOP gives one compare B
+	   event per period, which is the ADC trigger. No timer interrupts. */
+	t.id		=ADC_SAMPLING_TIMER;
+	t.mode		=TIMER_MODE_CTC;
+	t.clock_sel	=TIMER01_CLK_OFF;
+	t.ocrA_init	=best_top;
+	TIMER_init(&t);
+	if (ADC_SAMPLING_TIMER == TIMER_ID_1) TIMER_setCompare(TIMER_ID_1, TIMER_CH_B, best_top);
+	TIMER_start(ADC_SAMPLING_TIMER, best_clk);
+
+	return best_hz;
+}
+
+void ADC_stopSampling(void) {
+	ADC_streamStop();
+}
+
+/* producer side, ISR only */
+static inline void adc_ring_push(uint16_t v) {
+	uint8_t head =adc_ring_head;
+	uint8_t used =(uint8_t)(head - adc_ring_tail);
+
+	if (used >= ADC_RING_SIZE) {
+		adc_ring_overruns++;
+		return;
+	}
+	adc_ring_buf[head & ADC_RING_MASK] =v;
+	ADC_COMPILER_BARRIER();
+	adc_ring_head =head + 1;		/* publish */
+	if (used >= adc_ring_hwm) adc_ring_hwm =used + 1;
+}
+
+uint8_t ADC_ringAcquire(const uint16_t **span) {
+	uint8_t tail	=adc_ring_tail;
+	uint8_t used	=(uint8_t)(adc_ring_head - tail);
+	uint8_t idx	=tail & ADC_RING_MASK;
+	uint8_t contig	=ADC_RING_SIZE - idx;
+
+	if (used < contig) contig =used;
+	ADC_COMPILER_BARRIER();
+	if (span) *span =&adc_ring_buf[idx];
+	return contig;
+}
+
+void ADC_ringRelease(uint8_t n) {
+	uint8_t tail =adc_ring_tail;
+	uint8_t used =(uint8_t)(adc_ring_head - tail);
+
+	if (n > used) n =used;
+	ADC_COMPILER_BARRIER();
+	adc_ring_tail =tail + n;
+}
+
+uint8_t ADC_ringAvailable(void) {
+	return (uint8_t)(adc_ring_head - adc_ring_tail);
+}
+
+uint16_t ADC_ringOverruns(void) {
+	uint16_t v;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		v =adc_ring_overruns;
+	}
+	return v;
+}
+
+uint8_t ADC_ringHighWater(void) {
+	return adc_ring_hwm;
+}
+
+void ADC_ringResetStats(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		adc_ring_overruns	=0;
+		adc_ring_hwm		=0;
+	}
+}
+
+
+/* ===================== Noise reduction sleep ===================== */
+
+/* One conversion: entering ADC Noise Reduction mode with the ADC idle starts
+   it, ADC_vect wakes us. Returns false if another interrupt ended the sleep
+   first; the conversion then finishes with the CPU running. */
+static bool adc_sleep_once(adc_plan_t plan) {
+	adc_sleep_done =0;
+	adc_select_plan(plan);
+	adc_set_clock(adc_ps_of(plan));
+	set_sleep_mode(SLEEP_MODE_ADC);
+
+	cli();
+	sleep_enable();
+	sei();			/* sei's one instruction delay: no wakeup lost before sleep */
+	sleep_cpu();
+	sleep_disable();
+
+	if (adc_sleep_done) return true;
+	while (!adc_sleep_done) { ADC_POLL_HOOK(); }
+	return false;
+}
+
+uint16_t ADC_readSleepPlan(adc_plan_t plan) {
+	uint8_t tries =ADC_SLEEP_RETRIES + 1;
+	uint8_t adate;
+#if ADC_SLEEP_MASK_TIMER2
+	uint8_t timsk;
+#endif
+
+	if (adc_mode != ADC_MODE_IDLE) return 0;
+	if (!(SREG & (1<<SREG_I))) return ADC_readPlan(plan);	/* nothing could wake us */
+
+	/* single conversion mode with ADIE is required for the sleep start;
+	   ADIF=1 drops a stale completion that would end the first sleep at once */
+	adate =ADCSRA & (1<<ADATE);
+	ADCSRA =(ADCSRA & ~(1<<ADATE)) | (1<<ADIE) | (1<<ADIF);
+#if ADC_SLEEP_MASK_TIMER2
+	timsk =TIMSK;
+	TIMSK =timsk & ~((1<<TOIE2)|(1<<OCIE2));
+#endif
+	adc_mode =ADC_MODE_SLEEP;
+
+	while (!adc_sleep_once(plan)) {
+		adc_sleep_early++;
+		if (--tries == 0) break;
+	}
+
+	adc_mode =ADC_MODE_IDLE;
+#if ADC_SLEEP_MASK_TIMER2
+	TIMSK =(TIMSK & ~((1<<TOIE2)|(1<<OCIE2))) | (timsk & ((1<<TOIE2)|(1<<OCIE2)));
+#endif
+	ADCSRA |= adate;
+	if (!saved_irq_enable) ADCSRA &= ~(1<<ADIE);
+	return adc_sleep_result;
+}
+
+uint16_t ADC_readSleep(adc_channel_t ch) {
+	return ADC_readSleepPlan(adc_plan_of(ch));
+}
+
+bool ADC_scanSleep(const adc_plan_t *plan, uint8_t n, uint16_t *out) {
+	if (!plan || !out || adc_mode != ADC_MODE_IDLE) return false;
+	while (n--) *out++ =ADC_readSleepPlan(*plan++);
+	return true;
+}
+
+uint16_t ADC_sleepEarlyWakeups(void) {
+	return adc_sleep_early;
+}
+
+
+/* ===================== Ping-pong block capture ===================== */
+
+bool ADC_blockStart(uint16_t *buf0, uint16_t *buf1, uint16_t len, adc_block_callback_t cb) {
+	if (!buf0 || !buf1 || buf0 == buf1 || len < 2 || (len & 1)) return false;
+	if (adc_mode != ADC_MODE_IDLE) return false;
+
+	adc_block_buf[0]	=buf0;
+	adc_block_buf[1]	=buf1;
+	adc_block_fill		=buf0;
+	adc_block_ready		=0;
+	adc_block_idx		=0;
+	adc_block_cb		=cb;
+	adc_block_len		=len;
+	return true;
+}
+
+void ADC_blockStop(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		adc_block_len	=0;
+		adc_block_ready	=0;
+		adc_block_cb	=0;
+	}
+}
+
+const uint16_t *ADC_blockGet(uint16_t *len) {
+	const uint16_t *p;
+	uint16_t n;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		p =adc_block_ready;
+		n =adc_block_len;
+	}
+	if (len) *len =p ? n : 0;
+	return p;
+}
+
+void ADC_blockRelease(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		adc_block_ready =0;
+	}
+}
+
+uint16_t ADC_blockOverruns(void) {
+	uint16_t v;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		v =adc_block_overruns;
+	}
+	return v;
+}
+
+/* ISR only: one store and one compare per sample, events twice per block */
+static inline void adc_block_push(uint16_t v) {
+	uint16_t *buf =adc_block_fill;
+	uint16_t idx  =adc_block_idx;
+
+	buf[idx++] =v;
+	if (idx == (adc_block_len >> 1)) {
+		adc_block_idx =idx;
+		if (adc_block_cb) adc_block_cb(ADC_BLOCK_HALF, buf, idx);
+	} else if (idx == adc_block_len) {
+		adc_block_idx =0;
+		if (adc_block_ready) adc_block_overruns++;
+		adc_block_ready =buf;
+		adc_block_fill	=(buf == adc_block_buf[0]) ? adc_block_buf[1] : adc_block_buf[0];
+		if (adc_block_cb) adc_block_cb(ADC_BLOCK_FULL, buf, idx);
+	} else {
+		adc_block_idx =idx;
+	}
+}
+
+
+/* ISR for ADC Conversion Complete - scan engine, sample ring or user callback */
+ISR(ADC_vect) {
+    uint16_t v = adc_get_result10();	/* before the scan engine touches ADMUX */
+    switch (adc_mode) {
+    case ADC_MODE_STREAM:
+        /* the trigger is the rising edge of the timer flag: clear it (write 1)
+           or the next compare match will not start a conversion */
+        if (adc_trig_flag) TIFR = adc_trig_flag;
+        if (ADC_PLAN_IS_8BIT(adc_stream_plan)) v >>= 2;
+        if (adc_os_step(&adc_stream_acc, &adc_stream_cnt, &v)) {
+            uint8_t ch = ADC_PLAN_CHANNEL(adc_stream_plan);
+            v = ADC_ISR_FILTER(ch, v);
+            if (adc_block_len) adc_block_push(v);
+            else               adc_ring_push(v);
+            if (ch < ADC_NUM_CHANNELS) adc_window_check(ch, v);
+        }
+        break;
+    case ADC_MODE_SCAN:   adc_scan_isr(v);  break;
+    case ADC_MODE_SLEEP:
+        adc_sleep_result = ADC_PLAN_IS_8BIT(ADMUX) ? (v >> 2) : v;
+        adc_sleep_done = 1;
+        break;
+    default: {
+        uint8_t ch = ADMUX & ADC_MUX_MASK;
+        if (ch < ADC_NUM_CHANNELS) adc_window_check(ch, v);
+        if (adc_cb) adc_cb(v);
+    } break;
+    }
+}
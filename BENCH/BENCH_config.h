@@ -0,0 +1,25 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    BENCH_config.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : APP (benchmark firmware)
+ *  SWC    : BENCH
+ *
+ */
+
+#ifndef BENCH_CONFIG_H_
+#define BENCH_CONFIG_H_
+
+/* Register simavr prints: every byte written to it goes to stdout, line
+   buffered. EEDR is never touched by the drivers under test. */
+#define BENCH_CONSOLE_REG	EEDR
+
+/* ISR latencies are the worst of this many consecutive interrupts */
+#define BENCH_ISR_SAMPLES	8
+
+/* timers armed while the software timer tick is measured */
+#define BENCH_SW_TIMERS		16
+
+/* ADC clock for the ADC benchmarks (ADPS) */
+#define BENCH_ADC_PRESCALER	ADC_PRESCALER_10BIT
+
+#endif /* BENCH_CONFIG_H_ */
@@ -0,0 +1,23 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    BENCH_isr_handlers.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : APP (benchmark firmware)
+ *  SWC    : BENCH
+ *
+ *  Compile-time bound timer handlers (TIMER_ISR_HANDLERS_H, set by the
+ *  Makefile). The body matches the runtime callback BENCH_program.c
+ *  registers on TIMER1_COMPB, so the two ISR numbers differ only by the
+ *  dispatch.
+ */
+
+#ifndef BENCH_ISR_HANDLERS_H_
+#define BENCH_ISR_HANDLERS_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t bench_isr_hits;
+
+static inline void bench_on_t0_ovf(void) { bench_isr_hits++; }
+#define TIMER_ISR_HANDLER_T0_OVF  bench_on_t0_ovf
+
+#endif /* BENCH_ISR_HANDLERS_H_ */
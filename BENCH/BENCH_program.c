@@ -0,0 +1,449 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    BENCH_program.c    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : APP (benchmark firmware)
+ *  SWC    : BENCH
+ *
+ *  Cycle benchmarks of the driver API, run under simavr (or on a chip with
+ *  a console on BENCH_CONSOLE_REG). Timer1 runs at clk/1 as the cycle
+ *  counter, so Timer1 itself is not reconfigured here.
+ *
+ *  Output, one line per metric, parsed by the Makefile:
+ *      BENCH cycles.<case> <n>   cycles per call, call overhead removed
+ *      BENCH isr.<case> <n>      interrupt response + ISR + reti, worst of
+ *                                BENCH_ISR_SAMPLES
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
+#include <simavr/avr/avr_mcu_section.h>
+
+#include "ADC_interface.h"
+#include "ADC_calib_interface.h"
+#include "ADC_filter_interface.h"
+#include "TIMER_interface.h"
+#include "TIMER_sw_interface.h"
+#include "TIMER_cap_interface.h"
+#include "TIMER_spwm_interface.h"
+#include "BENCH_config.h"
+
+AVR_MCU(F_CPU, "atmega32");
+AVR_MCU_SIMAVR_CONSOLE(&BENCH_CONSOLE_REG);
+
+typedef void (*bench_fn_t)(void);
+
+typedef struct {
+	const char *name;	/* in flash */
+	bench_fn_t  fn;
+} bench_case_t;
+
+/* ===================== Console ===================== */
+static void bench_putc(char c) {
+	BENCH_CONSOLE_REG =(uint8_t)c;
+}
+
+static void bench_puts_P(const char *s) {
+	char c;
+	while ((c =(char)pgm_read_byte(s++)) != 0) bench_putc(c);
+}
+
+static void bench_putu(uint16_t v) {
+	char buf[5];
+	uint8_t n =0;
+	do { buf[n++] =(char)('0' + v % 10); v /=10; } while (v);
+	while (n) bench_putc(buf[--n]);
+}
+
+static void bench_report(const char *kind, const char *name, uint16_t v) {
+	bench_puts_P(PSTR("BENCH "));
+	bench_puts_P(kind);
+	bench_puts_P(name);
+	bench_putc(' ');
+	bench_putu(v);
+	bench_putc('\n');
+}
+
+/* ===================== Measurement ===================== */
+static uint16_t bench_call_overhead;
+static uint16_t bench_isr_overhead;
+
+static void bench_empty(void) { }
+
+/* cycles of fn() with interrupts off, including the indirect call */
+static uint16_t bench_run(bench_fn_t fn) {
+	uint8_t sreg =SREG;
+	uint16_t t0, t1;
+
+	cli();
+	t0 =TCNT1;
+	fn();
+	t1 =TCNT1;
+	SREG =sreg;
+	return (uint16_t)(t1 - t0);
+}
+
+/* Opens a one instruction interrupt window. With a flag pending this costs
+   the response, the vector jmp, the ISR and reti on top of the window. */
+static uint16_t bench_isr_window(void) {
+	uint16_t t0, t1;
+
+	t0 =TCNT1;
+	sei();
+	__asm__ __volatile__ ("nop");
+	cli();
+	t1 =TCNT1;
+	return (uint16_t)(t1 - t0);
+}
+
+/* wait with interrupts off until ADC_vect is pending, then take it.
+   single: start each conversion (no engine running) */
+static uint16_t bench_adc_isr(bool single) {
+	uint16_t worst =0, c;
+	uint8_t i;
+
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		if (single) ADC_startConversion(ADC_CH0);
+		while (!(ADCSRA & (1<<ADIF))) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	return worst;
+}
+
+/* ===================== Cases: TIMER ===================== */
+static const TIMER_Config_t bench_t0_cfg ={
+	.id =TIMER_ID_0, .mode =TIMER_MODE_FAST_PWM, .clock_sel =TIMER01_CLK_8,
+	.oc_mode_A =TIMER_OC_CLEAR, .ocrA_init =128, .configure_oc_pins =1
+};
+static const TIMER_Config_t bench_t2_cfg ={
+	.id =TIMER_ID_2, .mode =TIMER_MODE_CTC, .clock_sel =TIMER2_CLK_64,
+	.ocrA_init =99
+};
+
+static void b_timer_init_t0(void)	{ TIMER_init(&bench_t0_cfg); }
+static void b_timer_init_t2(void)	{ TIMER_init(&bench_t2_cfg); }
+static void b_timer_start(void)		{ TIMER_start(TIMER_ID_2, TIMER2_CLK_64); }
+static void b_timer_stop(void)		{ TIMER_stop(TIMER_ID_2); }
+static void b_timer_setMode(void)	{ TIMER_setMode(TIMER_ID_0, TIMER_MODE_FAST_PWM); }
+static void b_timer_setCompare_t0(void)	{ TIMER_setCompare(TIMER_ID_0, TIMER_CH_A, 100); }
+static void b_timer_setCompare_t1b(void) { TIMER_setCompare(TIMER_ID_1, TIMER_CH_B, 1000); }
+/* the out-of-line form a run-time id takes */
+static void b_timer_setCompare_t0_rt(void) { (TIMER_setCompare)(TIMER_ID_0, TIMER_CH_A, 100); }
+static void b_timer_setDutyRaw(void)	{ TIMER_setDutyRaw(TIMER_ID_0, TIMER_CH_A, 200); }
+static void b_timer_getCounter(void)	{ (void)TIMER_getCounter(TIMER_ID_0); }
+static void b_timer_setCounter(void)	{ TIMER_setCounter(TIMER_ID_2, 0); }
+static void b_timer_getCounter_t1(void)	{ (void)TIMER_getCounter(TIMER_ID_1); }
+static void b_timer_nowTicks(void)	{ (void)TIMER_nowTicks(); }
+static void b_timer_nowMicros(void)	{ (void)TIMER_nowMicros(); }
+
+static TIMER_SW_t bench_sw[BENCH_SW_TIMERS];
+static void bench_sw_cb(void *arg)	{ (void)arg; }
+
+static void b_timer_swStart(void)	{ TIMER_swStart(&bench_sw[0], 300, 0); }
+static void b_timer_swStop(void)	{ TIMER_swStop(&bench_sw[0]); }
+
+/* Timer2 compare ISR running the wheel with BENCH_SW_TIMERS timers armed,
+   one of them periodic every tick */
+static uint16_t bench_sw_isr(void) {
+	uint16_t worst =0, c;
+	uint8_t i;
+
+	for (i =0; i < BENCH_SW_TIMERS; i++) {
+		TIMER_swSetup(&bench_sw[i], bench_sw_cb, 0);
+		TIMER_swStart(&bench_sw[i], 1 + i * 37u, i ? 0 : 1);
+	}
+	TIMER_swInit();
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		while (!(TIFR & (1<<OCF2))) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	TIMER_stop(TIMER_ID_2);
+	return worst;
+}
+
+/* Timer1 capture ISR, both edges. ICP1 is driven as an output: writing
+   PORTD6 captures like an external edge. */
+static uint16_t bench_cap_isr(void) {
+	uint16_t worst =0, c;
+	uint8_t i;
+
+	DDRD |= (1<<PD6);
+	TIMER_capStart(TIMER_CAP_BOTH, false);
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		PORTD ^= (1<<PD6);
+		while (!(TIFR & (1<<ICF1))) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	TIMER_capStop();
+	DDRD &= (uint8_t)~(1<<PD6);
+	return worst;
+}
+
+/* Software PWM compare ISR with n channels on PORTA..PORTC, duties
+   100, 101, ...: one slot each. The first slot is taken only once the
+   counter has passed the last, so one interrupt applies all n slots. */
+static uint16_t bench_spwm_isr(uint8_t n) {
+	uint16_t worst =0, c;
+	uint8_t i;
+
+	TIMER_spwmInit();
+	for (i =0; i < n; i++) {
+		(void)TIMER_spwmAddChannel((TIMER_SpwmPort_t)(i >> 3), i & 7);
+		TIMER_spwmSetDuty(i, (uint8_t)(100 + i));
+	}
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		/* period start (at count 1), then wait past the slots */
+		while (!(TIFR & (1<<OCF0)) || TCNT0 >= 100) { }
+		(void)bench_isr_window();
+		while (!(TIFR & (1<<OCF0)) || TCNT0 < (uint8_t)(101 + n)) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	TIMER_spwmStop();
+	DDRA =0;
+	DDRB =0;
+	DDRC =0;
+	return worst;
+}
+
+/* Timer2 overflow ISR with a dithered OC2 and no callback registered yet:
+   the accumulator step and the OCR2 write. */
+static const TIMER_Config_t bench_t2_pwm_cfg ={
+	.id =TIMER_ID_2, .mode =TIMER_MODE_FAST_PWM, .clock_sel =TIMER2_CLK_8,
+	.oc_mode_A =TIMER_OC_CLEAR
+};
+
+static uint16_t bench_dither_isr(void) {
+	uint16_t worst =0, c;
+	uint8_t i;
+
+	TIMER_init(&bench_t2_pwm_cfg);
+	TIMER_ditherSet(TIMER_ID_2, TIMER_CH_A, 0x1234);
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		while (!(TIFR & (1<<TOV2))) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	TIMER_ditherStop(TIMER_ID_2, TIMER_CH_A);
+	TIMER_stop(TIMER_ID_2);
+	return worst;
+}
+
+/* Two vectors with the same one-line handler and no driver service:
+   TIMER0_OVF compiled in (BENCH_isr_handlers.h), TIMER1_COMPB through a
+   TIMER_setCallback pointer. Timer1 keeps running as the clk/1 stopwatch,
+   so OCF1B comes once per 65536 cycles. */
+volatile uint8_t bench_isr_hits;
+static void bench_t1b_cb(void)		{ bench_isr_hits++; }
+
+static uint16_t bench_dispatch_isr(bool stat) {
+	uint16_t worst =0, c;
+	uint8_t i, flag =stat ? (1<<TOV0) : (1<<OCF1B);
+
+	if (stat) {
+		TIMER_init(&bench_t0_cfg);
+		TIMER_enableInterrupts(TIMER_ID_0, 1, 0, 0);
+	} else {
+		TIMER_setCallback(TIMER_VECT_T1_COMPB, bench_t1b_cb);
+		TIFR =(1<<OCF1B);
+		TIMSK |= (1<<OCIE1B);
+	}
+	for (i =0; i < BENCH_ISR_SAMPLES; i++) {
+		while (!(TIFR & flag)) { }
+		c =(uint16_t)(bench_isr_window() - bench_isr_overhead);
+		if (c > worst) worst =c;
+	}
+	if (stat) {
+		TIMER_enableInterrupts(TIMER_ID_0, 0, 0, 0);
+		TIMER_stop(TIMER_ID_0);
+	} else {
+		TIMSK &= (uint8_t)~(1<<OCIE1B);
+	}
+	return worst;
+}
+
+/* ===================== Cases: ADC ===================== */
+static const ADC_Config_t bench_adc_cfg ={
+	.ref =ADC_REF_AVCC, .align =ADC_ALIGN_RIGHT, .prescaler =BENCH_ADC_PRESCALER,
+	.trigger_src =ADC_TRIG_FREE_RUNNING
+};
+
+static void b_adc_init(void)		{ ADC_init(&bench_adc_cfg); }
+static void b_adc_readBlocking(void)	{ (void)ADC_readBlocking(ADC_CH0); }
+static void b_adc_read8(void)		{ (void)ADC_read8(ADC_CH1); }
+static void b_adc_readPlan(void)	{ (void)ADC_readPlan(ADC_PLAN(ADC_CH2, ADC_REF_AVCC, ADC_ALIGN_LEFT)); }
+static void b_adc_startConversion(void)	{ ADC_startConversion(ADC_CH0); }
+static void b_adc_scanGetResult(void)	{ (void)ADC_scanGetResult(ADC_CH0); }
+static void b_adc_ringAvailable(void)	{ (void)ADC_ringAvailable(); }
+static void b_adc_calibToMillivolts(void) { (void)ADC_calibToMillivolts(ADC_CH0, 600); }
+static void b_adc_calibNtcDeciC(void)	{ (void)ADC_calibNtcDeciC(600); }
+
+static void bench_adc_cb(uint16_t v)	{ (void)v; }
+
+/* filters, one Step per call on a sample that keeps moving so the median
+   does not settle into one branch */
+static ADC_FiltMa_t	bench_ma;
+static ADC_FiltIir1_t	bench_iir1;
+static ADC_FiltBiquad_t	bench_bq;
+static ADC_FiltMedian_t	bench_med;
+static uint16_t		bench_x =512;
+
+static void b_adc_filtMaStep(void)	{ (void)ADC_filtMaStep(&bench_ma, bench_x +=37); }
+static void b_adc_filtIir1Step(void)	{ (void)ADC_filtIir1Step(&bench_iir1, bench_x +=37); }
+static void b_adc_filtBiquadStep(void)	{ (void)ADC_filtBiquadStep(&bench_bq, bench_x +=37); }
+static void b_adc_filtMedianStep(void)	{ (void)ADC_filtMedianStep(&bench_med, bench_x +=37); }
+
+/* ===================== Case table ===================== */
+#define BENCH_CASE(n)	static const char bench_n_##n[] PROGMEM = #n;
+BENCH_CASE(TIMER_init_t0)
+BENCH_CASE(TIMER_init_t2)
+BENCH_CASE(TIMER_start)
+BENCH_CASE(TIMER_stop)
+BENCH_CASE(TIMER_setMode)
+BENCH_CASE(TIMER_setCompare_t0)
+BENCH_CASE(TIMER_setCompare_t1b)
+BENCH_CASE(TIMER_setCompare_t0_rt)
+BENCH_CASE(TIMER_setDutyRaw)
+BENCH_CASE(TIMER_getCounter)
+BENCH_CASE(TIMER_setCounter)
+BENCH_CASE(TIMER_getCounter_t1)
+BENCH_CASE(TIMER_nowTicks)
+BENCH_CASE(TIMER_nowMicros)
+BENCH_CASE(TIMER_swStart)
+BENCH_CASE(TIMER_swStop)
+BENCH_CASE(ADC_init)
+BENCH_CASE(ADC_readBlocking_first)
+BENCH_CASE(ADC_readBlocking)
+BENCH_CASE(ADC_read8)
+BENCH_CASE(ADC_readPlan)
+BENCH_CASE(ADC_startConversion)
+BENCH_CASE(ADC_scanGetResult)
+BENCH_CASE(ADC_ringAvailable)
+BENCH_CASE(ADC_calibToMillivolts)
+BENCH_CASE(ADC_calibNtcDeciC)
+BENCH_CASE(ADC_filtMaStep)
+BENCH_CASE(ADC_filtIir1Step)
+BENCH_CASE(ADC_filtBiquadStep)
+BENCH_CASE(ADC_filtMedianStep)
+#undef BENCH_CASE
+
+/* order matters: ADC_init, then the first (25 clock) conversion */
+static const bench_case_t bench_cases[] PROGMEM ={
+	{ bench_n_TIMER_init_t0,		b_timer_init_t0 },
+	{ bench_n_TIMER_init_t2,		b_timer_init_t2 },
+	{ bench_n_TIMER_start,			b_timer_start },
+	{ bench_n_TIMER_stop,			b_timer_stop },
+	{ bench_n_TIMER_setMode,		b_timer_setMode },
+	{ bench_n_TIMER_setCompare_t0,		b_timer_setCompare_t0 },
+	{ bench_n_TIMER_setCompare_t1b,		b_timer_setCompare_t1b },
+	{ bench_n_TIMER_setCompare_t0_rt,	b_timer_setCompare_t0_rt },
+	{ bench_n_TIMER_setDutyRaw,		b_timer_setDutyRaw },
+	{ bench_n_TIMER_getCounter,		b_timer_getCounter },
+	{ bench_n_TIMER_setCounter,		b_timer_setCounter },
+	{ bench_n_TIMER_getCounter_t1,		b_timer_getCounter_t1 },
+	{ bench_n_TIMER_nowTicks,		b_timer_nowTicks },
+	{ bench_n_TIMER_nowMicros,		b_timer_nowMicros },
+	{ bench_n_TIMER_swStart,		b_timer_swStart },
+	{ bench_n_TIMER_swStop,			b_timer_swStop },
+	{ bench_n_ADC_init,			b_adc_init },
+	{ bench_n_ADC_readBlocking_first,	b_adc_readBlocking },
+	{ bench_n_ADC_readBlocking,		b_adc_readBlocking },
+	{ bench_n_ADC_read8,			b_adc_read8 },
+	{ bench_n_ADC_readPlan,			b_adc_readPlan },
+	{ bench_n_ADC_startConversion,		b_adc_startConversion },
+	{ bench_n_ADC_scanGetResult,		b_adc_scanGetResult },
+	{ bench_n_ADC_ringAvailable,		b_adc_ringAvailable },
+	{ bench_n_ADC_calibToMillivolts,	b_adc_calibToMillivolts },
+	{ bench_n_ADC_calibNtcDeciC,		b_adc_calibNtcDeciC },
+	{ bench_n_ADC_filtMaStep,		b_adc_filtMaStep },
+	{ bench_n_ADC_filtIir1Step,		b_adc_filtIir1Step },
+	{ bench_n_ADC_filtBiquadStep,		b_adc_filtBiquadStep },
+	{ bench_n_ADC_filtMedianStep,		b_adc_filtMedianStep },
+};
+
+static const char bench_k_cycles[] PROGMEM = "cycles.";
+static const char bench_k_isr[]    PROGMEM = "isr.";
+static const char bench_n_adc_cb[]     PROGMEM = "ADC_vect_callback";
+static const char bench_n_adc_scan[]   PROGMEM = "ADC_vect_scan";
+static const char bench_n_adc_stream[] PROGMEM = "ADC_vect_stream";
+static const char bench_n_sw_tick[]    PROGMEM = "TIMER2_COMP_vect_swtimer";
+static const char bench_n_cap[]        PROGMEM = "TIMER1_CAPT_vect";
+static const char bench_n_spwm1[]      PROGMEM = "TIMER0_COMP_vect_spwm1";
+static const char bench_n_spwm8[]      PROGMEM = "TIMER0_COMP_vect_spwm8";
+static const char bench_n_spwm16[]     PROGMEM = "TIMER0_COMP_vect_spwm16";
+static const char bench_n_spwm24[]     PROGMEM = "TIMER0_COMP_vect_spwm24";
+static const char bench_n_t0_static[]  PROGMEM = "TIMER0_OVF_vect_static";
+static const char bench_n_t1b_runtime[] PROGMEM = "TIMER1_COMPB_vect_runtime";
+static const char bench_n_t2_dither[]  PROGMEM = "TIMER2_OVF_vect_dither";
+
+int main(void) {
+	static const adc_channel_t scan[] ={ ADC_CH0, ADC_CH1, ADC_CH2 };
+	ADC_Config_t irq_cfg =bench_adc_cfg;
+	const uint16_t *span;
+	uint8_t i;
+
+	/* Timer1: normal mode, clk/1 */
+	TCCR1A =0;
+	TCCR1B =(1<<CS10);
+
+	bench_call_overhead =bench_run(bench_empty);
+	bench_isr_overhead  =bench_isr_window();
+	TIMER_swSetup(&bench_sw[0], bench_sw_cb, 0);
+	ADC_filtMaInit(&bench_ma, 512);
+	ADC_filtIir1Init(&bench_iir1, 512);
+	ADC_filtBiquadInit(&bench_bq, 512);
+	ADC_filtMedianInit(&bench_med, 512);
+
+	for (i =0; i < sizeof bench_cases / sizeof bench_cases[0]; i++) {
+		const char *name =(const char *)pgm_read_ptr(&bench_cases[i].name);
+		bench_fn_t fn =(bench_fn_t)pgm_read_ptr(&bench_cases[i].fn);
+		bench_report(bench_k_cycles, name, (uint16_t)(bench_run(fn) - bench_call_overhead));
+	}
+
+	/* ISR(ADC_vect), legacy single conversion + callback */
+	irq_cfg.interrupt_enable =true;
+	ADC_init(&irq_cfg);
+	ADC_setCallback(bench_adc_cb);
+	bench_report(bench_k_isr, bench_n_adc_cb, bench_adc_isr(true));
+
+	/* scan engine, free running */
+	ADC_init(&bench_adc_cfg);
+	ADC_scanStart(scan, 3);
+	bench_report(bench_k_isr, bench_n_adc_scan, bench_adc_isr(false));
+	ADC_scanStop();
+
+	/* stream into the ring; the ring never fills in BENCH_ISR_SAMPLES */
+	ADC_streamStart(ADC_CH0);
+	bench_report(bench_k_isr, bench_n_adc_stream, bench_adc_isr(false));
+	ADC_streamStop();
+	ADC_ringRelease(ADC_ringAcquire(&span));
+
+	/* software timer tick */
+	bench_report(bench_k_isr, bench_n_sw_tick, bench_sw_isr());
+
+	/* input capture, one edge per interrupt */
+	bench_report(bench_k_isr, bench_n_cap, bench_cap_isr());
+
+	/* software PWM, every slot in one interrupt */
+	bench_report(bench_k_isr, bench_n_spwm1, bench_spwm_isr(1));
+	bench_report(bench_k_isr, bench_n_spwm8, bench_spwm_isr(8));
+	bench_report(bench_k_isr, bench_n_spwm16, bench_spwm_isr(16));
+	bench_report(bench_k_isr, bench_n_spwm24, bench_spwm_isr(24));
+
+	/* vector dispatch: compile-time handler vs runtime callback */
+	bench_report(bench_k_isr, bench_n_t2_dither, bench_dither_isr());
+	bench_report(bench_k_isr, bench_n_t0_static, bench_dispatch_isr(true));
+	bench_report(bench_k_isr, bench_n_t1b_runtime, bench_dispatch_isr(false));
+
+	/* simavr ends the run on sleep with interrupts off */
+	cli();
+	sleep_enable();
+	sleep_cpu();
+	for (;;) { }
+}
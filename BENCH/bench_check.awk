@@ -0,0 +1,35 @@
+# Compares bench results with the baseline: "metric value" per line, '#'
+# comments. Fails when a metric grows by more than tol percent, when a
+# metric is missing from either side and when the baseline is empty.
+#   awk -v tol=0 -f bench_check.awk bench_baseline.txt results.txt
+
+FNR == NR {
+	if ($0 !~ /^#/ && NF == 2) base[$1] = $2
+	next
+}
+/^#/ || NF != 2 { next }
+{
+	cur[$1] = $2
+	if (!($1 in base)) {
+		printf "  NEW   %-40s %8d (not in the baseline)\n", $1, $2
+		nnew++
+		next
+	}
+	limit = base[$1] + base[$1] * tol / 100
+	if ($2 > limit) {
+		printf "  FAIL  %-40s %8d -> %8d (%+d)\n", $1, base[$1], $2, $2 - base[$1]
+		nfail++
+	} else if ($2 != base[$1]) {
+		printf "  ok    %-40s %8d -> %8d (%+d)\n", $1, base[$1], $2, $2 - base[$1]
+	}
+}
+END {
+	for (k in base) if (!(k in cur)) {
+		printf "  GONE  %s (not in the results)\n", k
+		ngone++
+	}
+	printf "bench: %d metrics, %d new, %d gone, %d regressions (tolerance %s%%)\n", length(cur), nnew, ngone, nfail, tol
+	if (length(base) == 0) print "bench: empty baseline, run 'make bench-baseline' on the reference toolchain and commit it"
+	else if (nnew || ngone) print "bench: metrics changed, review them and run 'make bench-baseline'"
+	exit (nfail || nnew || ngone || length(base) == 0) ? 1 : 0
+}
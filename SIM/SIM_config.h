@@ -0,0 +1,35 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    SIM_config.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ */
+
+#ifndef SIM_CONFIG_H_
+#define SIM_CONFIG_H_
+
+/*========================================Timing Model========================================*/
+/* Simulated CPU cycles charged for one register access: in/out for the
+   I/O space (data address 0x20..0x5F, every ATmega32 register), lds/sts
+   above it. A read-modify-write is counted once. Code between register
+   accesses is not timed: this is a behavioural model, not an ISS. */
+#define SIM_IO_ACCESS_CYCLES		1
+#define SIM_ACCESS_CYCLES		2
+
+/* Interrupt response (4) + vector jmp (3), and reti */
+#define SIM_ISR_ENTRY_CYCLES		7
+#define SIM_ISR_EXIT_CYCLES		4
+
+/* A sleep that nothing can end is a firmware hang on the chip; the model
+   reports it and aborts after this many simulated cycles. */
+#define SIM_SLEEP_TIMEOUT_CYCLES	100000000UL
+
+/*========================================ADC Model========================================*/
+/* Default input for every MUX setting (0..1023) until SIM_adcSetInput() */
+#define SIM_ADC_DEFAULT_INPUT		512
+
+/* MUX = 11110: 1.22 V bandgap, expressed in counts of a 5 V reference */
+#define SIM_ADC_BANDGAP_COUNTS		250
+
+#endif /* SIM_CONFIG_H_ */
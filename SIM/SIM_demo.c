@@ -0,0 +1,237 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    SIM_demo.c    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : APP (host simulation example)
+ *  SWC    : SIM
+ *
+ *  Runs the unmodified ADC and TIMER drivers on the simulated ATmega32:
+ *  a blocking read, a scan round, timer paced sampling into the ring, a
+ *  Noise Reduction sleep read, a Timer0 fast PWM waveform, software
+ *  timers on the Timer2 tick, input capture of a pulse train on ICP1,
+ *  three software PWM channels on PORTC, a phase-locked start of all
+ *  three timers and a 16-bit dithered duty on OC2.
+ *
+ *  Every result is checked against its expected value or range; a
+ *  mismatch prints a FAIL line and the exit status is nonzero
+ *  (make test).
+ */
+
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "SIM_interface.h"
+#include "ADC_interface.h"
+#include "TIMER_interface.h"
+#include "TIMER_sw_interface.h"
+#include "TIMER_cap_interface.h"
+#include "TIMER_spwm_interface.h"
+
+static void demo_count(void *arg) {
+	++*(uint16_t *)arg;
+}
+
+static uint32_t ocr_sum;
+static uint16_t ocr_n;
+static void demo_ocr2_sum(void) {
+	ocr_sum +=OCR2;
+	ocr_n++;
+}
+
+static uint16_t demo_ramp(uint8_t mux, uint64_t cycle) {
+	return (uint16_t)(mux * 100u + (cycle / 1000u) % 100u);
+}
+
+static uint8_t demo_fails;
+
+/* got must lie in lo..hi */
+static void demo_check(const char *what, long got, long lo, long hi) {
+	if (got >= lo && got <= hi) return;
+	if (lo == hi) printf("FAIL      %s = %ld, expected %ld\n", what, got, lo);
+	else printf("FAIL      %s = %ld, expected %ld..%ld\n", what, got, lo, hi);
+	demo_fails++;
+}
+
+int main(void) {
+	static const adc_channel_t scan[] ={ ADC_CH0, ADC_CH3, ADC_CH5 };
+	const ADC_Config_t adc ={
+		.ref =ADC_REF_AVCC, .align =ADC_ALIGN_RIGHT, .prescaler =ADC_PRESCALER_10BIT,
+		.auto_trigger =false, .trigger_src =ADC_TRIG_FREE_RUNNING,
+		.interrupt_enable =false, .didr_mask =0, .oversample_bits =0
+	};
+	const TIMER_Config_t pwm ={
+		.id =TIMER_ID_0, .mode =TIMER_MODE_FAST_PWM, .clock_sel =TIMER01_CLK_8,
+		.oc_mode_A =TIMER_OC_CLEAR, .ocrA_init =64, .configure_oc_pins =1
+	};
+	static TIMER_SW_t sw[3];
+	static uint16_t sw_hits[3];
+	TIMER_CapStats_t cap;
+	uint32_t mhz;
+	const uint16_t *span;
+	uint64_t t0, t1;
+	static const uint8_t spwm_duty[3] ={ 1, 100, 101 };
+	/* three phases 120 degrees apart at clk/8 */
+	static const TIMER_Group_t phases ={
+		{ TIMER01_CLK_8, TIMER01_CLK_8, TIMER2_CLK_8 }, { 0, 85, 170 }
+	};
+	TIMER_Config_t ph ={ .mode =TIMER_MODE_FAST_PWM, .clock_sel =0 };
+	int8_t skew[3];
+	const TIMER_Config_t dith ={
+		.id =TIMER_ID_2, .mode =TIMER_MODE_FAST_PWM, .clock_sel =TIMER2_CLK_8,
+		.oc_mode_A =TIMER_OC_CLEAR, .configure_oc_pins =1
+	};
+	uint32_t rate, high =0, i, sp_high[3] ={ 0 };
+	uint16_t v, late;
+	uint8_t n, measured;
+
+	SIM_reset();
+	SIM_adcSetInput(ADC_CH0, 100);
+	SIM_adcSetInput(ADC_CH3, 300);
+	SIM_adcSetInput(ADC_CH5, 1000);
+
+	ADC_init(&adc);
+	t0 =SIM_cycles();
+	v =ADC_readBlocking(ADC_CH3);
+	printf("blocking  CH3 = %u (%lu cycles, first conversion)\n", v, (unsigned long)(SIM_cycles() - t0));
+	demo_check("blocking CH3", v, 300, 300);
+	demo_check("blocking cycles", (long)(SIM_cycles() - t0), 25 * 64, 25 * 64 + 16);	/* 25 ADC clocks at clk/64 */
+
+	sei();
+	ADC_scanStart(scan, 3);
+	while (ADC_scanRounds() == 0) SIM_run(100);
+	ADC_scanStop();
+	printf("scan      CH0 = %u CH3 = %u CH5 = %u\n",
+	       ADC_scanGetResult(ADC_CH0), ADC_scanGetResult(ADC_CH3), ADC_scanGetResult(ADC_CH5));
+	demo_check("scan CH0", ADC_scanGetResult(ADC_CH0), 100, 100);
+	demo_check("scan CH3", ADC_scanGetResult(ADC_CH3), 300, 300);
+	demo_check("scan CH5", ADC_scanGetResult(ADC_CH5), 1000, 1000);
+
+	SIM_adcSetSource(demo_ramp);
+	rate =ADC_startSampling(ADC_CH1, 2000);
+	SIM_run(F_CPU / 100);			/* 10 ms */
+	ADC_stopSampling();
+	n =ADC_ringAcquire(&span);
+	printf("sampling  %lu Hz: %u samples, first %u last %u, %lu ADC ISRs\n",
+	       (unsigned long)rate, n, n ? span[0] : 0, n ? span[n - 1] : 0,
+	       (unsigned long)SIM_isrCount(SIM_VECT_ADC));
+	demo_check("sampling rate", (long)rate, 2000, 2000);
+	demo_check("sampling samples", n, 19, 20);		/* 10 ms at 2 kHz */
+	/* the ramp climbs 1 per 1000 cycles: 4 per 4000 cycle period */
+	if (n) demo_check("sampling ramp", span[n - 1] - span[0], (n - 1) * 4L, (n - 1) * 4L);
+	demo_check("sampling ADC ISRs", (long)SIM_isrCount(SIM_VECT_ADC), n, 100);
+	ADC_ringRelease(n);
+
+	SIM_adcSetSource(0);
+	v =ADC_readSleep(ADC_CH5);
+	printf("sleep     CH5 = %u, early wakeups %u\n", v, ADC_sleepEarlyWakeups());
+	demo_check("sleep CH5", v, 1000, 1000);
+	demo_check("sleep early wakeups", ADC_sleepEarlyWakeups(), 0, 0);
+
+	TIMER_init(&pwm);
+	SIM_run(2048);				/* OCR0 is buffered until BOTTOM in fast PWM */
+	for (i =0; i < 2560; i++) {		/* 10 PWM periods in 8 cycle steps */
+		SIM_run(8);
+		high +=SIM_ocLevel(SIM_OC0);
+	}
+	printf("pwm       OC0 high %lu/2560 timer clocks (OCR0 = 64: 650 expected)\n", (unsigned long)high);
+	demo_check("pwm OC0 high", (long)high, 650, 650);
+
+	TIMER_swInit();
+	for (i =0; i < 3; i++) TIMER_swSetup(&sw[i], demo_count, &sw_hits[i]);
+	TIMER_swStart(&sw[0], TIMER_SW_MS(10), TIMER_SW_MS(10));
+	TIMER_swStart(&sw[1], TIMER_SW_MS(25), TIMER_SW_MS(25));
+	TIMER_swStart(&sw[2], TIMER_SW_MS(60), 0);
+	SIM_run(F_CPU / 10);			/* 100 ms */
+	printf("swtimer   10 ms x%u, 25 ms x%u, 60 ms one-shot x%u after %lu ticks\n",
+	       sw_hits[0], sw_hits[1], sw_hits[2], (unsigned long)TIMER_swNow());
+	demo_check("swtimer 10 ms", sw_hits[0], 10, 10);
+	demo_check("swtimer 25 ms", sw_hits[1], 4, 4);
+	demo_check("swtimer 60 ms", sw_hits[2], 1, 1);
+	demo_check("swtimer ticks", (long)TIMER_swNow(), 100, 100);
+
+	/* start-up self-test, before the time base takes Timer1 */
+	measured =TIMER_groupSkewTest(skew);
+
+	/* 20 kHz, 30 % duty on ICP1, both edges, noise canceller on */
+	TIMER_timebaseInit();
+	TIMER_capStart(TIMER_CAP_BOTH, true);
+	TIMER_capStatsReset(&cap);
+	for (i =0; i < 200; i++) {
+		SIM_pinSet(SIM_PORT_D, 6, 1);
+		SIM_run(120);
+		SIM_pinSet(SIM_PORT_D, 6, 0);
+		SIM_run(280);
+		TIMER_capProcess(&cap);
+	}
+	TIMER_capStop();
+	mhz =TIMER_capFrequencyMilliHz(&cap);
+	printf("capture   %lu.%03lu Hz, duty %u/1000, jitter %lu ns over %u periods, %u lost\n",
+	       (unsigned long)(mhz / 1000), (unsigned long)(mhz % 1000), TIMER_capDutyPermille(&cap),
+	       (unsigned long)TIMER_capJitterNs(&cap), cap.periods, TIMER_capOverruns());
+	demo_check("capture mHz", (long)mhz, 20000000L - 100, 20000000L + 100);
+	demo_check("capture duty", TIMER_capDutyPermille(&cap), 299, 301);
+	demo_check("capture jitter ns", (long)TIMER_capJitterNs(&cap), 0, 125);	/* one clk/8 tick */
+	demo_check("capture periods", cap.periods, 199, 199);
+	demo_check("capture lost", TIMER_capOverruns(), 0, 0);
+
+	/* Timer0 at clk/64: 64 cycles per count, 256 counts per period */
+	TIMER_spwmInit();
+	for (n =0; n < 3; n++) {
+		TIMER_spwmAddChannel(TIMER_SPWM_PORT_C, n);
+		TIMER_spwmSetDuty(n, spwm_duty[n]);
+	}
+	SIM_run(2 * 64 * 256UL);		/* the schedule starts at a period start */
+	t0 =t1 =SIM_cycles();
+	v =PORTC;
+	while (t1 - t0 < 4 * 64 * 256UL) {	/* 4 periods, cycles at each level */
+		SIM_run(8);
+		for (n =0; n < 3; n++) sp_high[n] +=((v >> n) & 1) * (uint32_t)(SIM_cycles() - t1);
+		t1 =SIM_cycles();
+		v =PORTC;
+	}
+	TIMER_spwmStop();
+	late =TIMER_spwmPeakLate();
+	printf("spwm      PORTC0..2 high %lu, %lu, %lu/1024 counts (4, 400, 404 less ISR latency), edge late <= %u\n",
+	       (unsigned long)((sp_high[0] + 32) / 64), (unsigned long)((sp_high[1] + 32) / 64),
+	       (unsigned long)((sp_high[2] + 32) / 64), late);
+	for (n =0; n < 3; n++) {
+		static const char *const name[3] ={ "spwm PORTC0 high", "spwm PORTC1 high", "spwm PORTC2 high" };
+		long want =4L * spwm_duty[n];
+		demo_check(name[n], (long)((sp_high[n] + 32) / 64), want - 2, want);
+	}
+	demo_check("spwm edge late", late, 0, 1);
+
+	TIMSK &= (uint8_t)~(1<<TOIE1);		/* time base done, Timer1 joins the group */
+	for (n =0; n < 3; n++) {
+		ph.id =(TIMER_ID_t)n;
+		TIMER_init(&ph);			/* clock off */
+	}
+	TIMER_startGroup(TIMER_GROUP_ALL, &phases);
+	SIM_run(10000);
+	{
+		uint8_t c0 =TCNT0, c1 =TCNT1L, c2 =TCNT2;
+		printf("group     clk/1 skew T1 %+d T2 %+d cycles; clk/8 after 10000 cycles T1-T0 %u, T2-T0 %u counts (85, 170)\n",
+		       skew[1], skew[2], (uint8_t)(c1 - c0), (uint8_t)(c2 - c0));
+		demo_check("group timers measured", measured, TIMER_GROUP_ALL, TIMER_GROUP_ALL);
+		demo_check("group skew T1", skew[1], 0, 0);
+		demo_check("group skew T2", skew[2], 0, 0);
+		demo_check("group T1-T0", (uint8_t)(c1 - c0), 85, 85);
+		demo_check("group T2-T0", (uint8_t)(c2 - c0), 170, 170);
+	}
+
+	/* OCR 16.25 in 8.8: the overflow callback runs after the dither step */
+	TIMER_init(&dith);
+	TIMER_setCallback(TIMER_VECT_T2_OVF, demo_ocr2_sum);
+	TIMER_ditherSet(TIMER_ID_2, TIMER_CH_A, 0x1040);
+	SIM_run(256 * 8 * 256UL);		/* 256 periods of 2048 cycles */
+	TIMER_ditherStop(TIMER_ID_2, TIMER_CH_A);
+	TIMER_setCallback(TIMER_VECT_T2_OVF, NULL);
+	printf("dither    OC2 mean OCR %lu.%02lu over %u periods (duty 0x1040: 16.25), OCR2 %u after stop\n",
+	       (unsigned long)(ocr_sum / ocr_n), (unsigned long)(ocr_sum % ocr_n * 100 / ocr_n), ocr_n, OCR2);
+	demo_check("dither mean OCR x100", (long)(ocr_sum * 100 / ocr_n), 1623, 1627);
+	demo_check("dither OCR2 after stop", OCR2, 16, 16);
+
+	if (demo_fails) printf("sim_demo: %u checks FAILED\n", demo_fails);
+	else printf("sim_demo: all checks passed\n");
+	return demo_fails ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    SIM_interface.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Virtual ATmega32 register file with a behavioural model of Timer0/1/2
+ *  (all WGM modes, compare/overflow/capture flags, OC pin levels, OCR
+ *  double buffering), the ADC (conversion timing, ADLAR presentation,
+ *  auto trigger sources, Noise Reduction sleep start) and interrupt
+ *  dispatch in vector priority order.
+ *
+ *  Build the drivers with -ISIM/include ahead of the toolchain headers and
+ *  link SIM_program.c: the sources in ADC/ and TIMER(0,1,2)/ compile as is.
+ *
+ *  Simulated time advances on every register access (SIM_IO_ACCESS_CYCLES),
+ *  on interrupt entry/exit, in _delay_us/_delay_ms, in sleep and in
+ *  SIM_run(). A loop that only polls RAM makes no register access: the
+ *  drivers call ADC_POLL_HOOK() in such loops, which the Makefile binds to
+ *  SIM_idle().
+ *
+ *  Known limitation: writing a W1C flag register (TIFR, ADIF) with exactly
+ *  the value it already reads is indistinguishable from a read and does not
+ *  clear the flags. Flags are always cleared on vector entry.
+ */
+
+#ifndef SIM_INTERFACE_H_
+#define SIM_INTERFACE_H_
+
+#include <stdint.h>
+
+/* ===================== Vectors (ATmega32 numbering) ===================== */
+typedef enum {
+	SIM_VECT_INT0		=1,
+	SIM_VECT_INT1		=2,
+	SIM_VECT_INT2		=3,
+	SIM_VECT_TIMER2_COMP	=4,
+	SIM_VECT_TIMER2_OVF	=5,
+	SIM_VECT_TIMER1_CAPT	=6,
+	SIM_VECT_TIMER1_COMPA	=7,
+	SIM_VECT_TIMER1_COMPB	=8,
+	SIM_VECT_TIMER1_OVF	=9,
+	SIM_VECT_TIMER0_COMP	=10,
+	SIM_VECT_TIMER0_OVF	=11,
+	SIM_VECT_ADC		=16,
+	SIM_VECT_COUNT		=21
+} SIM_Vector_t;
+
+/* ===================== Ports / OC outputs ===================== */
+typedef enum {
+	SIM_PORT_A =0,
+	SIM_PORT_B,
+	SIM_PORT_C,
+	SIM_PORT_D
+} SIM_Port_t;
+
+typedef enum {
+	SIM_OC0 =0,	/* PB3 */
+	SIM_OC1A,	/* PD5 */
+	SIM_OC1B,	/* PD4 */
+	SIM_OC2		/* PD7 */
+} SIM_OC_t;
+
+/* Optional ADC input model: counts (0..1023) for a MUX setting at a time */
+typedef uint16_t (*SIM_AdcSource_t)(uint8_t mux, uint64_t cycle);
+
+/* ===================== API ===================== */
+void     SIM_reset(void);                       /* power-on state, time = 0 */
+void     SIM_run(uint32_t cycles);              /* let time pass with the CPU idle in a loop */
+uint64_t SIM_cycles(void);                      /* simulated CPU cycles since reset */
+
+void     SIM_adcSetInput(uint8_t mux, uint16_t counts);
+void     SIM_adcSetSource(SIM_AdcSource_t src); /* overrides the fixed inputs, 0 to remove */
+uint32_t SIM_adcConversions(void);
+
+void     SIM_pinSet(SIM_Port_t port, uint8_t pin, uint8_t level); /* drives PINx; T0/T1/ICP1 edges */
+uint8_t  SIM_ocLevel(SIM_OC_t oc);              /* waveform generator output level */
+
+uint32_t SIM_isrCount(SIM_Vector_t v);          /* times the vector was taken */
+
+void     SIM_consoleSet(volatile uint8_t *reg); /* bytes written to reg go to stdout, 0 to remove */
+
+/* Used by the avr/ shim headers */
+volatile uint8_t  *SIM_reg8 (uint16_t mem_addr);
+volatile uint16_t *SIM_reg16(uint16_t mem_addr);
+void     SIM_idle(void);
+void     SIM_sleep(void);
+
+#endif /* SIM_INTERFACE_H_ */
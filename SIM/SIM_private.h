@@ -0,0 +1,93 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    SIM_private.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ */
+
+#ifndef SIM_PRIVATE_H_
+#define SIM_PRIVATE_H_
+
+/* ===================== Data memory map ===================== */
+#define SIM_MEM_SIZE		0x60	/* registers live at 0x20..0x5F */
+#define SIM_IO(io_addr)		((io_addr) + 0x20)
+
+#define SIM_ADCL	SIM_IO(0x04)
+#define SIM_ADCH	SIM_IO(0x05)
+#define SIM_ADCSRA	SIM_IO(0x06)
+#define SIM_ADMUX	SIM_IO(0x07)
+#define SIM_PIND	SIM_IO(0x10)
+#define SIM_PINC	SIM_IO(0x13)
+#define SIM_PINB	SIM_IO(0x16)
+#define SIM_PINA	SIM_IO(0x19)
+#define SIM_OCR2	SIM_IO(0x23)
+#define SIM_TCNT2	SIM_IO(0x24)
+#define SIM_TCCR2	SIM_IO(0x25)
+#define SIM_ICR1	SIM_IO(0x26)
+#define SIM_OCR1B	SIM_IO(0x28)
+#define SIM_OCR1A	SIM_IO(0x2A)
+#define SIM_TCNT1	SIM_IO(0x2C)
+#define SIM_TCCR1B	SIM_IO(0x2E)
+#define SIM_TCCR1A	SIM_IO(0x2F)
+#define SIM_SFIOR	SIM_IO(0x30)
+#define SIM_TCNT0	SIM_IO(0x32)
+#define SIM_TCCR0	SIM_IO(0x33)
+#define SIM_MCUCR	SIM_IO(0x35)
+#define SIM_TIFR	SIM_IO(0x38)
+#define SIM_TIMSK	SIM_IO(0x39)
+#define SIM_GIFR	SIM_IO(0x3A)
+#define SIM_GICR	SIM_IO(0x3B)
+#define SIM_OCR0	SIM_IO(0x3C)
+#define SIM_SREG	SIM_IO(0x3F)
+
+/* ===================== Bits used by the model ===================== */
+#define SIM_SREG_I	0x80
+
+#define SIM_ADEN	0x80
+#define SIM_ADSC	0x40
+#define SIM_ADATE	0x20
+#define SIM_ADIF	0x10
+#define SIM_ADIE	0x08
+#define SIM_ADLAR	0x20
+
+#define SIM_PSR10	0x01
+#define SIM_PSR2	0x02
+
+#define SIM_SE		0x80
+#define SIM_SM_SHIFT	4
+#define SIM_SM_IDLE	0
+#define SIM_SM_ADC	1
+
+/* TIFR / TIMSK bit positions */
+#define SIM_TOV0	0
+#define SIM_OCF0	1
+#define SIM_TOV1	2
+#define SIM_OCF1B	3
+#define SIM_OCF1A	4
+#define SIM_ICF1	5
+#define SIM_TOV2	6
+#define SIM_OCF2	7
+
+/* ADTS2..0 */
+#define SIM_TRIG_FREE	0
+#define SIM_TRIG_T0COMP	3
+#define SIM_TRIG_T0OVF	4
+#define SIM_TRIG_T1COMPB 5
+#define SIM_TRIG_T1OVF	6
+#define SIM_TRIG_T1CAPT	7
+
+/* Conversion lengths in ADC clocks */
+#define SIM_ADC_FIRST_CLOCKS	25
+#define SIM_ADC_CONV_CLOCKS	13
+
+/* Counting behaviour derived from WGM */
+typedef enum {
+	SIM_WG_NORMAL =0,	/* single slope, TOV at MAX */
+	SIM_WG_CTC,		/* single slope, clear at TOP, TOV at MAX */
+	SIM_WG_FAST,		/* single slope, TOV at TOP, OCR update at BOTTOM */
+	SIM_WG_PC,		/* dual slope, TOV at BOTTOM, OCR update at TOP */
+	SIM_WG_PFC		/* dual slope, TOV at BOTTOM, OCR update at BOTTOM */
+} sim_wg_t;
+
+#endif /* SIM_PRIVATE_H_ */
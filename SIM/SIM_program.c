@@ -0,0 +1,690 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    SIM_program.c    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Author : Ahmed Shaban
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Register file + behavioural ATmega32 peripheral model. The firmware
+ *  accesses registers through SIM_reg8()/SIM_reg16(); each call first
+ *  applies the side effects of whatever the CPU wrote since the previous
+ *  call (found by diffing the register file against a snapshot), then lets
+ *  an in/out or lds/sts worth of cycles pass, takes pending interrupts, and
+ *  hands out the cell.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SIM_interface.h"
+#include "SIM_private.h"
+#include "SIM_config.h"
+
+/* ===================== Vector table (weak: unused vectors need no handler) ===================== */
+void SIM_vect_INT0(void)	__attribute__((weak));
+void SIM_vect_INT1(void)	__attribute__((weak));
+void SIM_vect_INT2(void)	__attribute__((weak));
+void SIM_vect_TIMER2_COMP(void)	__attribute__((weak));
+void SIM_vect_TIMER2_OVF(void)	__attribute__((weak));
+void SIM_vect_TIMER1_CAPT(void)	__attribute__((weak));
+void SIM_vect_TIMER1_COMPA(void) __attribute__((weak));
+void SIM_vect_TIMER1_COMPB(void) __attribute__((weak));
+void SIM_vect_TIMER1_OVF(void)	__attribute__((weak));
+void SIM_vect_TIMER0_COMP(void)	__attribute__((weak));
+void SIM_vect_TIMER0_OVF(void)	__attribute__((weak));
+void SIM_vect_ADC(void)		__attribute__((weak));
+
+typedef void (*sim_isr_t)(void);
+
+/* ===================== State ===================== */
+static union {
+	uint8_t  b[SIM_MEM_SIZE];
+	uint16_t w[SIM_MEM_SIZE / 2];
+} sim_mem;
+static uint8_t	sim_shadow[SIM_MEM_SIZE];	/* register file as the CPU last saw it */
+
+static uint64_t	sim_now;
+static uint16_t	sim_psc10;			/* Timer0/1 prescaler */
+static uint16_t	sim_psc2;			/* Timer2 prescaler */
+static uint8_t	sim_clkio_halted;		/* ADC Noise Reduction sleep */
+static uint32_t	sim_isr_count[SIM_VECT_COUNT];
+static uint8_t	sim_console;			/* simavr style console register, 0: none */
+
+typedef struct {
+	uint16_t ocr_act[2];	/* compare values in use (OCR is double buffered in PWM) */
+	uint8_t  down;		/* dual slope direction */
+	uint8_t  block;		/* TCNT written: no compare match on the next timer clock */
+} sim_timer_t;
+static sim_timer_t sim_tmr[3];
+
+static uint8_t	sim_oc[4];			/* waveform outputs, SIM_OC_t order */
+static uint8_t	sim_pin_ext[4];			/* externally driven levels */
+
+static uint16_t	sim_adc_in[32];
+static SIM_AdcSource_t sim_adc_src;
+static uint8_t	sim_adc_busy;
+static uint8_t	sim_adc_first;			/* next conversion is the 25 clock one */
+static uint8_t	sim_adc_mux;			/* latched at conversion start */
+static uint32_t	sim_adc_left;			/* CPU cycles to completion */
+static uint16_t	sim_adc_raw;
+static uint32_t	sim_adc_convs;
+
+static uint32_t	sim_icp_left;			/* noise canceller delay, 0 = none pending */
+static uint8_t	sim_icp_level;			/* ICP1 (PD6) as last seen */
+
+/* ===================== Small helpers ===================== */
+static void sim_fatal(const char *msg) {
+	fprintf(stderr, "SIM: %s (cycle %llu)\n", msg, (unsigned long long)sim_now);
+	exit(2);
+}
+
+static inline uint8_t  rd8 (uint8_t a)			{ return sim_mem.b[a]; }
+static inline void     wr8 (uint8_t a, uint8_t v)	{ sim_mem.b[a] =v; }
+static inline uint16_t rd16(uint8_t a)			{ return sim_mem.w[a / 2]; }
+static inline void     wr16(uint8_t a, uint16_t v)	{ sim_mem.w[a / 2] =v; }
+
+static void sim_adc_trigger(uint8_t src);
+
+static void sim_set_tifr(uint8_t bit) {
+	static const uint8_t trig_of[8] ={ 0xFF, 0xFF, SIM_TRIG_T1OVF, SIM_TRIG_T1COMPB,
+					   0xFF, SIM_TRIG_T1CAPT, 0xFF, 0xFF };
+	uint8_t m =(uint8_t)(1u << bit);
+
+	if (rd8(SIM_TIFR) & m) return;		/* no new edge for the ADC trigger */
+	wr8(SIM_TIFR, rd8(SIM_TIFR) | m);
+	if (bit == SIM_TOV0) sim_adc_trigger(SIM_TRIG_T0OVF);
+	else if (bit == SIM_OCF0) sim_adc_trigger(SIM_TRIG_T0COMP);
+	else if (trig_of[bit] != 0xFF) sim_adc_trigger(trig_of[bit]);
+}
+
+/* ===================== Pins ===================== */
+static const uint8_t sim_pin_addr[4] ={ SIM_PINA, SIM_PINB, SIM_PINC, SIM_PIND };
+
+static uint8_t sim_pin_level(uint8_t port) {
+	uint8_t pin =sim_pin_addr[port];
+	uint8_t ddr =rd8((uint8_t)(pin + 1));
+	uint8_t out =rd8((uint8_t)(pin + 2));
+	uint8_t com0 =(rd8(SIM_TCCR0) >> 4) & 3, com2 =(rd8(SIM_TCCR2) >> 4) & 3;
+	uint8_t com1a =rd8(SIM_TCCR1A) >> 6, com1b =(rd8(SIM_TCCR1A) >> 4) & 3;
+
+	/* a connected compare output overrides PORTx, the pin still needs DDR */
+	if (port == SIM_PORT_B && com0) out =(uint8_t)((out & ~0x08) | (sim_oc[SIM_OC0] << 3));
+	if (port == SIM_PORT_D) {
+		if (com1a) out =(uint8_t)((out & ~0x20) | (sim_oc[SIM_OC1A] << 5));
+		if (com1b) out =(uint8_t)((out & ~0x10) | (sim_oc[SIM_OC1B] << 4));
+		if (com2)  out =(uint8_t)((out & ~0x80) | (sim_oc[SIM_OC2] << 7));
+	}
+	return (uint8_t)((ddr & out) | (~ddr & sim_pin_ext[port]));
+}
+
+static void sim_icp_edge(uint8_t rising);
+
+/* ICP1 follows its pin whoever drives it: with DDRD6 set, writing PORTD6
+   captures, as on the chip */
+static void sim_pins_update(void) {
+	uint8_t p, icp;
+	for (p =0; p < 4; p++) wr8(sim_pin_addr[p], sim_pin_level(p));
+	icp =(rd8(SIM_PIND) >> 6) & 1;
+	if (icp != sim_icp_level) {
+		sim_icp_level =icp;
+		sim_icp_edge(icp);
+	}
+}
+
+/* ===================== Timers ===================== */
+typedef struct {
+	sim_wg_t wg;
+	uint16_t top, max;
+	uint8_t  cs;
+	uint8_t  com[2];
+	uint8_t  nch;
+	uint8_t  toggle_a;	/* COM=01 toggles OCnA in this PWM mode */
+	uint8_t  top_icr;	/* ICR1 is TOP: ICF1 at TOP, no capture */
+} sim_tcfg_t;
+
+static const uint8_t sim_tcnt_addr[3]	={ SIM_TCNT0, SIM_TCNT1, SIM_TCNT2 };
+static const uint8_t sim_ocr_addr[3][2]	={ { SIM_OCR0, 0 }, { SIM_OCR1A, SIM_OCR1B }, { SIM_OCR2, 0 } };
+static const uint8_t sim_tov_bit[3]	={ SIM_TOV0, SIM_TOV1, SIM_TOV2 };
+static const uint8_t sim_ocf_bit[3][2]	={ { SIM_OCF0, 0 }, { SIM_OCF1A, SIM_OCF1B }, { SIM_OCF2, 0 } };
+static const uint8_t sim_oc_of[3][2]	={ { SIM_OC0, 0 }, { SIM_OC1A, SIM_OC1B }, { SIM_OC2, 0 } };
+
+static void sim_timer_cfg(uint8_t t, sim_tcfg_t *c) {
+	memset(c, 0, sizeof *c);
+	if (t == 1) {
+		static const sim_wg_t wg[16] ={
+			SIM_WG_NORMAL, SIM_WG_PC, SIM_WG_PC, SIM_WG_PC, SIM_WG_CTC, SIM_WG_FAST, SIM_WG_FAST, SIM_WG_FAST,
+			SIM_WG_PFC, SIM_WG_PFC, SIM_WG_PC, SIM_WG_PC, SIM_WG_CTC, SIM_WG_NORMAL, SIM_WG_FAST, SIM_WG_FAST };
+		uint8_t a =rd8(SIM_TCCR1A), b =rd8(SIM_TCCR1B);
+		uint8_t wgm =(uint8_t)((a & 0x03) | ((b >> 1) & 0x0C));
+
+		c->wg =wg[wgm];
+		c->max =0xFFFF;
+		switch (wgm) {
+		case 1: case 5:			c->top =0x00FF; break;
+		case 2: case 6:			c->top =0x01FF; break;
+		case 3: case 7:			c->top =0x03FF; break;
+		case 4:				c->top =rd16(SIM_OCR1A); break;
+		case 9: case 11: case 15:	c->top =sim_tmr[1].ocr_act[0]; c->toggle_a =1; break;
+		case 8: case 10: case 12: case 14: c->top =rd16(SIM_ICR1); c->top_icr =1; break;
+		default:			c->top =0xFFFF; break;
+		}
+		c->cs =b & 0x07;
+		c->com[0] =a >> 6;
+		c->com[1] =(a >> 4) & 3;
+		c->nch =2;
+	} else {
+		static const sim_wg_t wg[4] ={ SIM_WG_NORMAL, SIM_WG_PC, SIM_WG_CTC, SIM_WG_FAST };
+		uint8_t r =rd8(t == 0 ? SIM_TCCR0 : SIM_TCCR2);
+
+		c->wg =wg[((r >> 6) & 1) | ((r >> 2) & 2)];
+		c->max =0xFF;
+		c->top =(c->wg == SIM_WG_CTC) ? rd8(sim_ocr_addr[t][0]) : 0xFF;
+		c->cs =r & 0x07;
+		c->com[0] =(r >> 4) & 3;
+		c->nch =1;
+	}
+}
+
+static uint16_t sim_tcnt(uint8_t t)		{ return t == 1 ? rd16(SIM_TCNT1) : rd8(sim_tcnt_addr[t]); }
+static void sim_tcnt_set(uint8_t t, uint16_t v)	{ if (t == 1) wr16(SIM_TCNT1, v); else wr8(sim_tcnt_addr[t], (uint8_t)v); }
+static uint16_t sim_ocr(uint8_t t, uint8_t ch)	{ return t == 1 ? rd16(sim_ocr_addr[1][ch]) : rd8(sim_ocr_addr[t][0]); }
+
+static void sim_oc_set(uint8_t oc, uint8_t level) { sim_oc[oc] =level; }
+
+/* Compare match output action; dir: 0 = counting up (or single slope), 1 = down */
+static void sim_oc_match(uint8_t t, uint8_t ch, const sim_tcfg_t *c, uint8_t dir) {
+	uint8_t oc =sim_oc_of[t][ch], com =c->com[ch];
+
+	if (!com) return;
+	if (c->wg == SIM_WG_NORMAL || c->wg == SIM_WG_CTC) {
+		if (com == 1) sim_oc_set(oc, !sim_oc[oc]);
+		else sim_oc_set(oc, com == 3);
+	} else if (com == 1) {
+		if (ch == 0 && c->toggle_a) sim_oc_set(oc, !sim_oc[oc]);
+	} else if (c->wg == SIM_WG_FAST) {
+		sim_oc_set(oc, com == 3);
+	} else {
+		sim_oc_set(oc, (com == 3) ^ dir);
+	}
+}
+
+static void sim_timer_update_ocr(uint8_t t, const sim_tcfg_t *c) {
+	uint8_t ch;
+	for (ch =0; ch < c->nch; ch++) sim_tmr[t].ocr_act[ch] =sim_ocr(t, ch);
+}
+
+static void sim_timer_clock(uint8_t t) {
+	sim_timer_t *tm =&sim_tmr[t];
+	sim_tcfg_t c;
+	uint16_t n;
+	uint8_t ch, block;
+
+	sim_timer_cfg(t, &c);
+	n =sim_tcnt(t);
+	block =tm->block;
+	tm->block =0;
+
+	if (c.wg == SIM_WG_NORMAL || c.wg == SIM_WG_CTC) sim_timer_update_ocr(t, &c);
+
+	/* the flag is set on the timer clock after TCNT equals OCR */
+	for (ch =0; ch < c.nch; ch++) {
+		if (!block && n == tm->ocr_act[ch]) {
+			sim_set_tifr(sim_ocf_bit[t][ch]);
+			sim_oc_match(t, ch, &c, tm->down);
+		}
+	}
+
+	if (c.wg == SIM_WG_PC || c.wg == SIM_WG_PFC) {
+		if (!tm->down) {
+			if (n >= c.top) {
+				tm->down =1;
+				if (c.top_icr) sim_set_tifr(SIM_ICF1);
+				if (c.wg == SIM_WG_PC) sim_timer_update_ocr(t, &c);
+				n =c.top ? (uint16_t)(c.top - 1) : 0;
+			} else {
+				n++;
+			}
+		} else {
+			n--;
+			if (n == 0) {
+				tm->down =0;
+				sim_set_tifr(sim_tov_bit[t]);
+				if (c.wg == SIM_WG_PFC) sim_timer_update_ocr(t, &c);
+			}
+		}
+	} else if (n == c.top && c.wg != SIM_WG_NORMAL) {
+		if (c.top_icr) sim_set_tifr(SIM_ICF1);
+		n =0;
+		if (c.wg == SIM_WG_FAST) {
+			sim_set_tifr(sim_tov_bit[t]);
+			sim_timer_update_ocr(t, &c);
+			for (ch =0; ch < c.nch; ch++) {
+				if (c.com[ch] >= 2) sim_oc_set(sim_oc_of[t][ch], c.com[ch] == 2);
+			}
+		} else if (c.top == c.max) {
+			sim_set_tifr(sim_tov_bit[t]);
+		}
+	} else if (n == c.max) {
+		n =0;
+		sim_set_tifr(sim_tov_bit[t]);
+	} else {
+		n++;
+	}
+	sim_tcnt_set(t, n);
+}
+
+static void sim_capture(void) {
+	sim_tcfg_t c;
+
+	sim_timer_cfg(1, &c);
+	if (c.top_icr) return;			/* ICR1 holds TOP, capture disabled */
+	wr16(SIM_ICR1, rd16(SIM_TCNT1));
+	sim_set_tifr(SIM_ICF1);
+}
+
+static void sim_icp_edge(uint8_t rising) {
+	uint8_t b =rd8(SIM_TCCR1B);
+
+	if (((b >> 6) & 1) != rising) return;
+	if (b & 0x80) sim_icp_left =4;		/* noise canceller */
+	else sim_capture();
+}
+
+/* External clock on T0 (PB0) / T1 (PB1): CS = 6 falling, 7 rising */
+static void sim_ext_clock(uint8_t t, uint8_t rising) {
+	uint8_t cs =rd8(t == 0 ? SIM_TCCR0 : SIM_TCCR1B) & 0x07;
+
+	if (sim_clkio_halted) return;
+	if ((cs == 6 && !rising) || (cs == 7 && rising)) sim_timer_clock(t);
+}
+
+static void sim_timers_cycle(void) {
+	static const uint16_t div10[8] ={ 0, 1, 8, 64, 256, 1024, 0, 0 };
+	static const uint16_t div2[8]  ={ 0, 1, 8, 32, 64, 128, 256, 1024 };
+	uint8_t cs;
+
+	sim_psc10 =(uint16_t)((sim_psc10 + 1) & 1023);
+	sim_psc2  =(uint16_t)((sim_psc2 + 1) & 1023);
+
+	cs =rd8(SIM_TCCR0) & 0x07;
+	if (div10[cs] && (sim_psc10 & (div10[cs] - 1)) == 0) sim_timer_clock(0);
+	cs =rd8(SIM_TCCR1B) & 0x07;
+	if (div10[cs] && (sim_psc10 & (div10[cs] - 1)) == 0) sim_timer_clock(1);
+	cs =rd8(SIM_TCCR2) & 0x07;
+	if (div2[cs] && (sim_psc2 & (div2[cs] - 1)) == 0) sim_timer_clock(2);
+
+	if (sim_icp_left && --sim_icp_left == 0) sim_capture();
+}
+
+/* ===================== ADC ===================== */
+static void sim_adc_present(void) {
+	if (rd8(SIM_ADMUX) & SIM_ADLAR) {
+		wr8(SIM_ADCH, (uint8_t)(sim_adc_raw >> 2));
+		wr8(SIM_ADCL, (uint8_t)(sim_adc_raw << 6));
+	} else {
+		wr8(SIM_ADCH, (uint8_t)(sim_adc_raw >> 8));
+		wr8(SIM_ADCL, (uint8_t)sim_adc_raw);
+	}
+}
+
+static void sim_adc_start(void) {
+	uint8_t ps =rd8(SIM_ADCSRA) & 0x07;
+	uint32_t div =ps ? (1u << ps) : 2u;
+
+	sim_adc_busy =1;
+	sim_adc_mux =rd8(SIM_ADMUX) & 0x1F;
+	sim_adc_left =div * (sim_adc_first ? SIM_ADC_FIRST_CLOCKS : SIM_ADC_CONV_CLOCKS);
+	sim_adc_first =0;
+	wr8(SIM_ADCSRA, rd8(SIM_ADCSRA) | SIM_ADSC);
+}
+
+static void sim_adc_complete(void) {
+	uint8_t sra;
+	uint16_t v;
+
+	if (sim_adc_src) v =sim_adc_src(sim_adc_mux, sim_now);
+	else v =sim_adc_in[sim_adc_mux];
+	sim_adc_raw =v > 1023 ? 1023 : v;
+	sim_adc_present();
+	sim_adc_convs++;
+
+	sim_adc_busy =0;
+	sra =(uint8_t)((rd8(SIM_ADCSRA) & ~SIM_ADSC) | SIM_ADIF);
+	wr8(SIM_ADCSRA, sra);
+
+	/* free running: the completion itself is the trigger */
+	if ((sra & SIM_ADATE) && (rd8(SIM_SFIOR) >> 5) == SIM_TRIG_FREE) sim_adc_start();
+}
+
+static void sim_adc_trigger(uint8_t src) {
+	uint8_t sra =rd8(SIM_ADCSRA);
+
+	if (!(sra & SIM_ADEN) || !(sra & SIM_ADATE) || sim_adc_busy) return;
+	if ((rd8(SIM_SFIOR) >> 5) != src) return;
+	sim_adc_start();
+}
+
+/* ===================== CPU writes ===================== */
+static void sim_on_write(uint8_t a, uint8_t old, uint8_t v) {
+	if (a == sim_console && a) {
+		if (v) putchar(v);
+		wr8(a, 0);				/* a repeated byte is a new write */
+		return;
+	}
+	switch (a) {
+	case SIM_TIFR:
+	case SIM_GIFR:
+		wr8(a, (uint8_t)(old & ~v));		/* write one to clear */
+		break;
+
+	case SIM_ADCSRA: {
+		uint8_t res =(uint8_t)((v & ~(SIM_ADIF | SIM_ADSC)) | (old & ~v & SIM_ADIF));
+		if (!(v & SIM_ADEN)) {
+			sim_adc_busy =0;		/* disabling aborts a conversion */
+		} else if (!(old & SIM_ADEN)) {
+			sim_adc_first =1;
+		}
+		wr8(a, (uint8_t)(res | (sim_adc_busy ? SIM_ADSC : 0)));
+		if ((v & SIM_ADEN) && (v & SIM_ADSC) && !sim_adc_busy) sim_adc_start();
+	} break;
+
+	case SIM_ADMUX:
+		sim_adc_present();			/* ADLAR applies to the result at once */
+		break;
+
+	case SIM_ADCL:
+	case SIM_ADCH:
+	case SIM_PINA:
+	case SIM_PINB:
+	case SIM_PINC:
+	case SIM_PIND:
+		wr8(a, old);				/* read only */
+		break;
+
+	case SIM_SFIOR:
+		if (v & SIM_PSR10) sim_psc10 =0;
+		if (v & SIM_PSR2)  sim_psc2 =0;
+		wr8(a, (uint8_t)(v & ~(SIM_PSR10 | SIM_PSR2)));
+		break;
+
+	case SIM_TCNT0:			sim_tmr[0].block =1; break;
+	case SIM_TCNT1: case SIM_TCNT1 + 1:	sim_tmr[1].block =1; break;
+	case SIM_TCNT2:			sim_tmr[2].block =1; break;
+
+	case SIM_TCCR0:
+	case SIM_TCCR2: {
+		uint8_t t =(a == SIM_TCCR0) ? 0 : 2;
+		sim_tcfg_t c;
+		if (v & 0x80) {				/* FOCn: output action, no flag */
+			sim_timer_cfg(t, &c);
+			if (c.wg == SIM_WG_NORMAL || c.wg == SIM_WG_CTC) sim_oc_match(t, 0, &c, 0);
+			wr8(a, (uint8_t)(v & 0x7F));
+		}
+	} break;
+
+	case SIM_TCCR1A: {
+		sim_tcfg_t c;
+		if (v & 0x0C) {
+			sim_timer_cfg(1, &c);
+			if (c.wg == SIM_WG_NORMAL || c.wg == SIM_WG_CTC) {
+				if (v & 0x08) sim_oc_match(1, 0, &c, 0);
+				if (v & 0x04) sim_oc_match(1, 1, &c, 0);
+			}
+			wr8(a, (uint8_t)(v & ~0x0C));
+		}
+	} break;
+
+	default:
+		break;
+	}
+}
+
+static void sim_commit(void) {
+	uint8_t a;
+
+	for (a =0x20; a < SIM_MEM_SIZE; a++) {
+		if (sim_mem.b[a] != sim_shadow[a]) sim_on_write(a, sim_shadow[a], sim_mem.b[a]);
+	}
+	sim_pins_update();
+	memcpy(sim_shadow, sim_mem.b, SIM_MEM_SIZE);
+}
+
+/* ===================== Time ===================== */
+static void sim_cycle(void) {
+	sim_now++;
+	if (!sim_clkio_halted) sim_timers_cycle();
+	if (sim_adc_busy && --sim_adc_left == 0) sim_adc_complete();
+}
+
+static void sim_advance(uint32_t n) {
+	while (n--) sim_cycle();
+	sim_pins_update();
+	memcpy(sim_shadow, sim_mem.b, SIM_MEM_SIZE);
+}
+
+/* ===================== Interrupts ===================== */
+typedef struct {
+	SIM_Vector_t v;
+	uint8_t flag_reg, flag_bit, en_reg, en_bit;
+	sim_isr_t *isr;
+} sim_vect_t;
+
+static sim_isr_t sim_isr_int0, sim_isr_int1, sim_isr_int2, sim_isr_t2c, sim_isr_t2o,
+		 sim_isr_t1cap, sim_isr_t1a, sim_isr_t1b, sim_isr_t1o, sim_isr_t0c, sim_isr_t0o, sim_isr_adc;
+
+/* priority order */
+static const sim_vect_t sim_vectors[] ={
+	{ SIM_VECT_INT0,	SIM_GIFR,   6, SIM_GICR,   6, &sim_isr_int0 },
+	{ SIM_VECT_INT1,	SIM_GIFR,   7, SIM_GICR,   7, &sim_isr_int1 },
+	{ SIM_VECT_INT2,	SIM_GIFR,   5, SIM_GICR,   5, &sim_isr_int2 },
+	{ SIM_VECT_TIMER2_COMP,	SIM_TIFR,   SIM_OCF2,  SIM_TIMSK, SIM_OCF2,  &sim_isr_t2c },
+	{ SIM_VECT_TIMER2_OVF,	SIM_TIFR,   SIM_TOV2,  SIM_TIMSK, SIM_TOV2,  &sim_isr_t2o },
+	{ SIM_VECT_TIMER1_CAPT,	SIM_TIFR,   SIM_ICF1,  SIM_TIMSK, SIM_ICF1,  &sim_isr_t1cap },
+	{ SIM_VECT_TIMER1_COMPA, SIM_TIFR,  SIM_OCF1A, SIM_TIMSK, SIM_OCF1A, &sim_isr_t1a },
+	{ SIM_VECT_TIMER1_COMPB, SIM_TIFR,  SIM_OCF1B, SIM_TIMSK, SIM_OCF1B, &sim_isr_t1b },
+	{ SIM_VECT_TIMER1_OVF,	SIM_TIFR,   SIM_TOV1,  SIM_TIMSK, SIM_TOV1,  &sim_isr_t1o },
+	{ SIM_VECT_TIMER0_COMP,	SIM_TIFR,   SIM_OCF0,  SIM_TIMSK, SIM_OCF0,  &sim_isr_t0c },
+	{ SIM_VECT_TIMER0_OVF,	SIM_TIFR,   SIM_TOV0,  SIM_TIMSK, SIM_TOV0,  &sim_isr_t0o },
+	{ SIM_VECT_ADC,		SIM_ADCSRA, 4,         SIM_ADCSRA, 3,        &sim_isr_adc },
+};
+#define SIM_NUM_VECTORS	(sizeof sim_vectors / sizeof sim_vectors[0])
+
+static const sim_vect_t *sim_pending(void) {
+	uint8_t i;
+
+	for (i =0; i < SIM_NUM_VECTORS; i++) {
+		const sim_vect_t *d =&sim_vectors[i];
+		if ((rd8(d->flag_reg) >> d->flag_bit) & (rd8(d->en_reg) >> d->en_bit) & 1) return d;
+	}
+	return 0;
+}
+
+static void sim_dispatch(void) {
+	const sim_vect_t *d;
+
+	while ((rd8(SIM_SREG) & SIM_SREG_I) && (d =sim_pending()) != 0) {
+		if (!*d->isr) {
+			char msg[64];
+			snprintf(msg, sizeof msg, "vector %d enabled without an ISR (bad interrupt)", (int)d->v);
+			sim_fatal(msg);
+		}
+		/* flag cleared by hardware on vector entry, I cleared until reti */
+		wr8(d->flag_reg, (uint8_t)(rd8(d->flag_reg) & ~(1u << d->flag_bit)));
+		wr8(SIM_SREG, (uint8_t)(rd8(SIM_SREG) & ~SIM_SREG_I));
+		sim_isr_count[d->v]++;
+		sim_advance(SIM_ISR_ENTRY_CYCLES);
+
+		(*d->isr)();
+
+		sim_commit();
+		wr8(SIM_SREG, (uint8_t)(rd8(SIM_SREG) | SIM_SREG_I));
+		sim_advance(SIM_ISR_EXIT_CYCLES);
+	}
+}
+
+/* ===================== API ===================== */
+static void __attribute__((constructor)) sim_power_on(void) {
+	SIM_reset();				/* the chip is in reset state before main() */
+}
+
+void SIM_consoleSet(volatile uint8_t *reg) {
+	sim_console =reg ? (uint8_t)(reg - (volatile uint8_t *)sim_mem.b) : 0;
+}
+
+void SIM_reset(void) {
+	uint8_t i;
+
+	memset(&sim_mem, 0, sizeof sim_mem);
+	memset(sim_tmr, 0, sizeof sim_tmr);
+	memset(sim_oc, 0, sizeof sim_oc);
+	memset(sim_pin_ext, 0, sizeof sim_pin_ext);
+	memset(sim_isr_count, 0, sizeof sim_isr_count);
+	for (i =0; i < 32; i++) sim_adc_in[i] =SIM_ADC_DEFAULT_INPUT;
+	sim_adc_in[0x1E] =SIM_ADC_BANDGAP_COUNTS;
+	sim_adc_in[0x1F] =0;
+	sim_adc_src =0;
+	sim_adc_busy =sim_adc_first =0;
+	sim_adc_raw =0;
+	sim_adc_convs =0;
+	sim_icp_left =0;
+	sim_icp_level =0;
+	sim_psc10 =sim_psc2 =0;
+	sim_clkio_halted =0;
+	sim_now =0;
+
+	sim_isr_int0 =SIM_vect_INT0;		sim_isr_int1 =SIM_vect_INT1;
+	sim_isr_int2 =SIM_vect_INT2;		sim_isr_t2c =SIM_vect_TIMER2_COMP;
+	sim_isr_t2o =SIM_vect_TIMER2_OVF;	sim_isr_t1cap =SIM_vect_TIMER1_CAPT;
+	sim_isr_t1a =SIM_vect_TIMER1_COMPA;	sim_isr_t1b =SIM_vect_TIMER1_COMPB;
+	sim_isr_t1o =SIM_vect_TIMER1_OVF;	sim_isr_t0c =SIM_vect_TIMER0_COMP;
+	sim_isr_t0o =SIM_vect_TIMER0_OVF;	sim_isr_adc =SIM_vect_ADC;
+
+	wr16(SIM_IO(0x3D), 0x085F);		/* SP = RAMEND, as after the C startup */
+	sim_pins_update();
+	memcpy(sim_shadow, sim_mem.b, SIM_MEM_SIZE);
+}
+
+void SIM_run(uint32_t cycles) {
+	uint64_t end;
+
+	sim_commit();
+	end =sim_now + cycles;
+	while (sim_now < end) {
+		sim_advance(1);
+		sim_dispatch();
+	}
+}
+
+uint64_t SIM_cycles(void) {
+	return sim_now;
+}
+
+volatile uint8_t *SIM_reg8(uint16_t mem_addr) {
+	if (mem_addr < 0x20 || mem_addr >= SIM_MEM_SIZE) sim_fatal("access outside the I/O register space");
+	sim_commit();
+	sim_advance(mem_addr < 0x60 ? SIM_IO_ACCESS_CYCLES : SIM_ACCESS_CYCLES);
+	sim_dispatch();
+	return &sim_mem.b[mem_addr];
+}
+
+/* One pass of a loop that waits for an ISR to set a RAM flag
+   (ADC_POLL_HOOK): time passes as for an in/out and pending interrupts are
+   taken. With interrupts disabled no ISR can end the loop. */
+void SIM_idle(void) {
+	sim_commit();
+	if (!(rd8(SIM_SREG) & SIM_SREG_I)) sim_fatal("RAM poll with interrupts disabled never ends");
+	sim_advance(SIM_IO_ACCESS_CYCLES);
+	sim_dispatch();
+}
+
+volatile uint16_t *SIM_reg16(uint16_t mem_addr) {
+	if (mem_addr < 0x20 || mem_addr >= SIM_MEM_SIZE - 1 || (mem_addr & 1)) sim_fatal("bad 16-bit register access");
+	sim_commit();
+	sim_advance(2 * (mem_addr < 0x60 ? SIM_IO_ACCESS_CYCLES : SIM_ACCESS_CYCLES));
+	sim_dispatch();
+	return &sim_mem.w[mem_addr / 2];
+}
+
+/* sleep: with SE clear the instruction is a no-op. ADC Noise Reduction
+   stops clkIO (timers) and starts a conversion if the ADC is idle; only the
+   ADC or an external interrupt wakes the CPU. Idle wakes on anything. */
+void SIM_sleep(void) {
+	uint8_t mode;
+	uint64_t limit;
+	const sim_vect_t *d;
+
+	sim_commit();
+	if (!(rd8(SIM_MCUCR) & SIM_SE)) return;
+	if (!(rd8(SIM_SREG) & SIM_SREG_I)) sim_fatal("sleep with interrupts disabled never wakes");
+
+	mode =(rd8(SIM_MCUCR) >> SIM_SM_SHIFT) & 0x07;
+	if (mode == SIM_SM_ADC) {
+		sim_clkio_halted =1;
+		if ((rd8(SIM_ADCSRA) & SIM_ADEN) && !sim_adc_busy) sim_adc_start();
+	} else if (mode != SIM_SM_IDLE) {
+		sim_clkio_halted =1;			/* power down / save / standby: ext int only */
+	}
+
+	limit =sim_now + SIM_SLEEP_TIMEOUT_CYCLES;
+	for (;;) {
+		d =sim_pending();
+		if (d && (mode == SIM_SM_IDLE || d->v == SIM_VECT_ADC || d->v <= SIM_VECT_INT2)) break;
+		if (sim_now >= limit) sim_fatal("sleep timed out with no wakeup source");
+		sim_cycle();
+	}
+	sim_clkio_halted =0;
+	sim_advance(4);					/* wake-up */
+	sim_dispatch();
+}
+
+void SIM_adcSetInput(uint8_t mux, uint16_t counts) {
+	sim_adc_in[mux & 0x1F] =counts;
+}
+
+void SIM_adcSetSource(SIM_AdcSource_t src) {
+	sim_adc_src =src;
+}
+
+uint32_t SIM_adcConversions(void) {
+	return sim_adc_convs;
+}
+
+void SIM_pinSet(SIM_Port_t port, uint8_t pin, uint8_t level) {
+	uint8_t before, after, m =(uint8_t)(1u << (pin & 7));
+
+	sim_commit();
+	before =sim_pin_level(port);
+	if (level) sim_pin_ext[port] |= m;
+	else sim_pin_ext[port] &= (uint8_t)~m;
+	after =sim_pin_level(port);
+
+	if ((before ^ after) & m) {
+		uint8_t rising =(after & m) != 0;
+
+		if (port == SIM_PORT_B && pin == 0) sim_ext_clock(0, rising);
+		if (port == SIM_PORT_B && pin == 1) sim_ext_clock(1, rising);
+
+		/* external interrupts: ISCn1:0 = 0 low level (not modelled), 1 any, 2 falling, 3 rising */
+		if (port == SIM_PORT_D && (pin == 2 || pin == 3)) {
+			uint8_t isc =(uint8_t)((rd8(SIM_MCUCR) >> (pin == 2 ? 0 : 2)) & 3);
+			if (isc == 1 || (isc == 2 && !rising) || (isc == 3 && rising))
+				wr8(SIM_GIFR, (uint8_t)(rd8(SIM_GIFR) | (pin == 2 ? 0x40 : 0x80)));
+		}
+		if (port == SIM_PORT_B && pin == 2) {
+			uint8_t isc2 =(rd8(SIM_IO(0x34)) >> 6) & 1;	/* MCUCSR.ISC2 */
+			if (isc2 == rising) wr8(SIM_GIFR, (uint8_t)(rd8(SIM_GIFR) | 0x20));
+		}
+	}
+	sim_pins_update();
+	memcpy(sim_shadow, sim_mem.b, SIM_MEM_SIZE);
+	sim_dispatch();
+}
+
+uint8_t SIM_ocLevel(SIM_OC_t oc) {
+	return sim_oc[oc];
+}
+
+uint32_t SIM_isrCount(SIM_Vector_t v) {
+	return v < SIM_VECT_COUNT ? sim_isr_count[v] : 0;
+}
@@ -0,0 +1,44 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    avr/interrupt.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  ISR(vector) defines a plain function with a per-vector name; the
+ *  simulator binds to it through a weak reference and calls it when the
+ *  vector's flag and enable bit are set and SREG.I is set.
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+/* ATmega32 vectors handled by the model */
+#define INT0_vect		SIM_vect_INT0
+#define INT1_vect		SIM_vect_INT1
+#define INT2_vect		SIM_vect_INT2
+#define TIMER2_COMP_vect	SIM_vect_TIMER2_COMP
+#define TIMER2_OVF_vect		SIM_vect_TIMER2_OVF
+#define TIMER1_CAPT_vect	SIM_vect_TIMER1_CAPT
+#define TIMER1_COMPA_vect	SIM_vect_TIMER1_COMPA
+#define TIMER1_COMPB_vect	SIM_vect_TIMER1_COMPB
+#define TIMER1_OVF_vect		SIM_vect_TIMER1_OVF
+#define TIMER0_COMP_vect	SIM_vect_TIMER0_COMP
+#define TIMER0_OVF_vect		SIM_vect_TIMER0_OVF
+#define ADC_vect		SIM_vect_ADC
+
+/* attributes have no meaning on the host */
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define ISR_ALIASOF(v)
+
+#define ISR(vector, ...)	void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector)	void vector(void); void vector(void) { }
+#define reti()			return
+
+#define sei()	(SREG |= (1 << SREG_I))
+#define cli()	(SREG &= (uint8_t)~(1 << SREG_I))
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
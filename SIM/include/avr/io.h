@@ -0,0 +1,256 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    avr/io.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  ATmega32 register file for the host build. Names, addresses and bit
+ *  numbers match avr-libc's <avr/iom32.h>, so driver code (and the bit
+ *  macros repeated in the drivers' private headers) compile unchanged.
+ */
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <avr/sfr_defs.h>
+
+#ifndef __AVR_ATmega32__
+#define __AVR_ATmega32__
+#endif
+
+/* ===================== Registers (I/O addresses) ===================== */
+#define TWBR	_SFR_IO8(0x00)
+#define TWSR	_SFR_IO8(0x01)
+#define TWAR	_SFR_IO8(0x02)
+#define TWDR	_SFR_IO8(0x03)
+#define ADCW	_SFR_IO16(0x04)
+#define ADC	_SFR_IO16(0x04)
+#define ADCL	_SFR_IO8(0x04)
+#define ADCH	_SFR_IO8(0x05)
+#define ADCSRA	_SFR_IO8(0x06)
+#define ADCSR	_SFR_IO8(0x06)
+#define ADMUX	_SFR_IO8(0x07)
+#define ACSR	_SFR_IO8(0x08)
+#define UBRRL	_SFR_IO8(0x09)
+#define UCSRB	_SFR_IO8(0x0A)
+#define UCSRA	_SFR_IO8(0x0B)
+#define UDR	_SFR_IO8(0x0C)
+#define SPCR	_SFR_IO8(0x0D)
+#define SPSR	_SFR_IO8(0x0E)
+#define SPDR	_SFR_IO8(0x0F)
+#define PIND	_SFR_IO8(0x10)
+#define DDRD	_SFR_IO8(0x11)
+#define PORTD	_SFR_IO8(0x12)
+#define PINC	_SFR_IO8(0x13)
+#define DDRC	_SFR_IO8(0x14)
+#define PORTC	_SFR_IO8(0x15)
+#define PINB	_SFR_IO8(0x16)
+#define DDRB	_SFR_IO8(0x17)
+#define PORTB	_SFR_IO8(0x18)
+#define PINA	_SFR_IO8(0x19)
+#define DDRA	_SFR_IO8(0x1A)
+#define PORTA	_SFR_IO8(0x1B)
+#define EECR	_SFR_IO8(0x1C)
+#define EEDR	_SFR_IO8(0x1D)
+#define EEAR	_SFR_IO16(0x1E)
+#define EEARL	_SFR_IO8(0x1E)
+#define EEARH	_SFR_IO8(0x1F)
+#define UBRRH	_SFR_IO8(0x20)
+#define UCSRC	UBRRH
+#define WDTCR	_SFR_IO8(0x21)
+#define ASSR	_SFR_IO8(0x22)
+#define OCR2	_SFR_IO8(0x23)
+#define TCNT2	_SFR_IO8(0x24)
+#define TCCR2	_SFR_IO8(0x25)
+#define ICR1	_SFR_IO16(0x26)
+#define ICR1L	_SFR_IO8(0x26)
+#define ICR1H	_SFR_IO8(0x27)
+#define OCR1B	_SFR_IO16(0x28)
+#define OCR1BL	_SFR_IO8(0x28)
+#define OCR1BH	_SFR_IO8(0x29)
+#define OCR1A	_SFR_IO16(0x2A)
+#define OCR1AL	_SFR_IO8(0x2A)
+#define OCR1AH	_SFR_IO8(0x2B)
+#define TCNT1	_SFR_IO16(0x2C)
+#define TCNT1L	_SFR_IO8(0x2C)
+#define TCNT1H	_SFR_IO8(0x2D)
+#define TCCR1B	_SFR_IO8(0x2E)
+#define TCCR1A	_SFR_IO8(0x2F)
+#define SFIOR	_SFR_IO8(0x30)
+#define OSCCAL	_SFR_IO8(0x31)
+#define OCDR	OSCCAL
+#define TCNT0	_SFR_IO8(0x32)
+#define TCCR0	_SFR_IO8(0x33)
+#define MCUCSR	_SFR_IO8(0x34)
+#define MCUCR	_SFR_IO8(0x35)
+#define TWCR	_SFR_IO8(0x36)
+#define SPMCR	_SFR_IO8(0x37)
+#define TIFR	_SFR_IO8(0x38)
+#define TIMSK	_SFR_IO8(0x39)
+#define GIFR	_SFR_IO8(0x3A)
+#define GICR	_SFR_IO8(0x3B)
+#define OCR0	_SFR_IO8(0x3C)
+#define SPL	_SFR_IO8(0x3D)
+#define SPH	_SFR_IO8(0x3E)
+#define SREG	_SFR_IO8(0x3F)
+
+/* ===================== Bits ===================== */
+/* ADMUX */
+#define MUX0	0
+#define MUX1	1
+#define MUX2	2
+#define MUX3	3
+#define MUX4	4
+#define ADLAR	5
+#define REFS0	6
+#define REFS1	7
+
+/* ADCSRA */
+#define ADPS0	0
+#define ADPS1	1
+#define ADPS2	2
+#define ADIE	3
+#define ADIF	4
+#define ADATE	5
+#define ADSC	6
+#define ADEN	7
+
+/* SFIOR */
+#define PSR10	0
+#define PSR2	1
+#define PUD	2
+#define ACME	3
+#define ADTS0	5
+#define ADTS1	6
+#define ADTS2	7
+
+/* MCUCR */
+#define ISC00	0
+#define ISC01	1
+#define ISC10	2
+#define ISC11	3
+#define SM0	4
+#define SM1	5
+#define SM2	6
+#define SE	7
+
+/* GICR / GIFR */
+#define INT1	7
+#define INT0	6
+#define INT2	5
+#define INTF1	7
+#define INTF0	6
+#define INTF2	5
+
+/* TCCR0 */
+#define CS00	0
+#define CS01	1
+#define CS02	2
+#define WGM01	3
+#define COM00	4
+#define COM01	5
+#define WGM00	6
+#define FOC0	7
+
+/* TCCR1A */
+#define WGM10	0
+#define WGM11	1
+#define FOC1B	2
+#define FOC1A	3
+#define COM1B0	4
+#define COM1B1	5
+#define COM1A0	6
+#define COM1A1	7
+
+/* TCCR1B */
+#define CS10	0
+#define CS11	1
+#define CS12	2
+#define WGM12	3
+#define WGM13	4
+#define ICES1	6
+#define ICNC1	7
+
+/* TCCR2 */
+#define CS20	0
+#define CS21	1
+#define CS22	2
+#define WGM21	3
+#define COM20	4
+#define COM21	5
+#define WGM20	6
+#define FOC2	7
+
+/* ASSR */
+#define TCR2UB	0
+#define OCR2UB	1
+#define TCN2UB	2
+#define AS2	3
+
+/* TIMSK */
+#define TOIE0	0
+#define OCIE0	1
+#define TOIE1	2
+#define OCIE1B	3
+#define OCIE1A	4
+#define TICIE1	5
+#define TOIE2	6
+#define OCIE2	7
+
+/* TIFR */
+#define TOV0	0
+#define OCF0	1
+#define TOV1	2
+#define OCF1B	3
+#define OCF1A	4
+#define ICF1	5
+#define TOV2	6
+#define OCF2	7
+
+/* SREG */
+#define SREG_C	0
+#define SREG_Z	1
+#define SREG_N	2
+#define SREG_V	3
+#define SREG_S	4
+#define SREG_H	5
+#define SREG_T	6
+#define SREG_I	7
+
+/* Port pins */
+#define PA0	0
+#define PA1	1
+#define PA2	2
+#define PA3	3
+#define PA4	4
+#define PA5	5
+#define PA6	6
+#define PA7	7
+#define PB0	0
+#define PB1	1
+#define PB2	2
+#define PB3	3
+#define PB4	4
+#define PB5	5
+#define PB6	6
+#define PB7	7
+#define PC0	0
+#define PC1	1
+#define PC2	2
+#define PC3	3
+#define PC4	4
+#define PC5	5
+#define PC6	6
+#define PC7	7
+#define PD0	0
+#define PD1	1
+#define PD2	2
+#define PD3	3
+#define PD4	4
+#define PD5	5
+#define PD6	6
+#define PD7	7
+
+#define RAMEND	0x85F
+
+#endif /* SIM_AVR_IO_H_ */
@@ -0,0 +1,15 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    avr/power.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  ATmega32 has no PRR; like avr-libc, nothing is defined for it.
+ */
+
+#ifndef SIM_AVR_POWER_H_
+#define SIM_AVR_POWER_H_
+
+#include <avr/io.h>
+
+#endif /* SIM_AVR_POWER_H_ */
@@ -0,0 +1,37 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    avr/sfr_defs.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Host replacement for avr-libc's <avr/sfr_defs.h>. Every register access
+ *  goes through SIM_reg8()/SIM_reg16(), which let simulated time pass and
+ *  apply the side effects of the previous access (flag clearing, starting
+ *  conversions, ...) before handing out the register cell.
+ */
+
+#ifndef SIM_AVR_SFR_DEFS_H_
+#define SIM_AVR_SFR_DEFS_H_
+
+#include <stdint.h>
+
+#define __SFR_OFFSET	0x20
+
+volatile uint8_t  *SIM_reg8 (uint16_t mem_addr);
+volatile uint16_t *SIM_reg16(uint16_t mem_addr);
+void SIM_idle(void);		/* ADC_POLL_HOOK() in the SIM build */
+
+#define _SFR_MEM8(mem_addr)	(*SIM_reg8(mem_addr))
+#define _SFR_MEM16(mem_addr)	(*SIM_reg16(mem_addr))
+#define _SFR_IO8(io_addr)	_SFR_MEM8((io_addr) + __SFR_OFFSET)
+#define _SFR_IO16(io_addr)	_SFR_MEM16((io_addr) + __SFR_OFFSET)
+
+#define _BV(bit)		(1 << (bit))
+
+#define bit_is_set(sfr, bit)	(_SFR_BYTE(sfr) & _BV(bit))
+#define bit_is_clear(sfr, bit)	(!(_SFR_BYTE(sfr) & _BV(bit)))
+#define loop_until_bit_is_set(sfr, bit)		do { } while (bit_is_clear(sfr, bit))
+#define loop_until_bit_is_clear(sfr, bit)	do { } while (bit_is_set(sfr, bit))
+#define _SFR_BYTE(sfr)		(sfr)
+
+#endif /* SIM_AVR_SFR_DEFS_H_ */
@@ -0,0 +1,28 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    avr/sleep.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ */
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+void SIM_sleep(void);
+
+#define SLEEP_MODE_IDLE		0
+#define SLEEP_MODE_ADC		_BV(SM0)
+#define SLEEP_MODE_PWR_DOWN	_BV(SM1)
+#define SLEEP_MODE_PWR_SAVE	(_BV(SM0) | _BV(SM1))
+#define SLEEP_MODE_STANDBY	(_BV(SM1) | _BV(SM2))
+#define SLEEP_MODE_EXT_STANDBY	(_BV(SM0) | _BV(SM1) | _BV(SM2))
+
+#define set_sleep_mode(mode)	(MCUCR = (MCUCR & (uint8_t)~(_BV(SM0) | _BV(SM1) | _BV(SM2))) | (mode))
+#define sleep_enable()		(MCUCR |= _BV(SE))
+#define sleep_disable()		(MCUCR &= (uint8_t)~_BV(SE))
+#define sleep_cpu()		SIM_sleep()
+#define sleep_mode()		do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+#endif /* SIM_AVR_SLEEP_H_ */
@@ -0,0 +1,24 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    simavr/avr/avr_mcu_section.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Host replacement for simavr's <simavr/avr/avr_mcu_section.h>. There is
+ *  no .mmcu section to fill: the console register is handed to the model,
+ *  which prints every byte written to it, as simavr does.
+ */
+
+#ifndef SIM_SIMAVR_AVR_MCU_SECTION_H_
+#define SIM_SIMAVR_AVR_MCU_SECTION_H_
+
+#include <avr/io.h>
+
+void SIM_consoleSet(volatile uint8_t *reg);
+
+#define AVR_MCU(freq, name)		extern int sim_avr_mcu_unused_
+#define AVR_MCU_SIMAVR_CONSOLE(reg) \
+	static void __attribute__((constructor)) sim_console_init_(void) { SIM_consoleSet(reg); } \
+	extern int sim_avr_mcu_unused_
+
+#endif /* SIM_SIMAVR_AVR_MCU_SECTION_H_ */
@@ -0,0 +1,31 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    util/atomic.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Same construction as avr-libc: SREG is saved, I is cleared for the
+ *  block and restored by a cleanup handler on every exit path.
+ */
+
+#ifndef SIM_UTIL_ATOMIC_H_
+#define SIM_UTIL_ATOMIC_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static __inline__ uint8_t __iSeiRetVal(void) { sei(); return 1; }
+static __inline__ uint8_t __iCliRetVal(void) { cli(); return 1; }
+static __inline__ void __iSeiParam(const uint8_t *__s) { (void)__s; sei(); }
+static __inline__ void __iCliParam(const uint8_t *__s) { (void)__s; cli(); }
+static __inline__ void __iRestore(const uint8_t *__s) { SREG = *__s; }
+
+#define ATOMIC_RESTORESTATE	uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = SREG
+#define ATOMIC_FORCEON		uint8_t sreg_save __attribute__((__cleanup__(__iSeiParam))) = 0
+#define NONATOMIC_RESTORESTATE	uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = SREG
+#define NONATOMIC_FORCEOFF	uint8_t sreg_save __attribute__((__cleanup__(__iCliParam))) = 0
+
+#define ATOMIC_BLOCK(type)	for (type, __ToDo = __iCliRetVal(); __ToDo; __ToDo = 0)
+#define NONATOMIC_BLOCK(type)	for (type, __ToDo = __iSeiRetVal(); __ToDo; __ToDo = 0)
+
+#endif /* SIM_UTIL_ATOMIC_H_ */
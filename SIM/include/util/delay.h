@@ -0,0 +1,24 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    util/delay.h (SIM)    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL (host simulation backend)
+ *  SWC    : SIM
+ *
+ *  Busy waits become simulated time, so timers and the ADC keep running.
+ */
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU	8000000UL
+#endif
+
+void SIM_run(uint32_t cycles);
+
+#define _delay_us(us)	SIM_run((uint32_t)((double)(us) * (F_CPU / 1e6)))
+#define _delay_ms(ms)	SIM_run((uint32_t)((double)(ms) * (F_CPU / 1e3)))
+
+#endif /* SIM_UTIL_DELAY_H_ */
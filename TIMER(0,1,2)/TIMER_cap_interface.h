@@ -0,0 +1,87 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    TIMER_cap_interface.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL
+ *  SWC    : TIMER (input capture)
+ *
+ *  Timer1 input capture on ICP1 (PD6, input). The hardware latches TCNT1
+ *  into ICR1 on the edge, so the timestamp does not depend on interrupt
+ *  latency; the ISR extends it with the time base overflow count to a
+ *  32-bit TIMER_nowTicks() value and queues it in a ring
+ *  (TIMER_CAP_RING, TIMER_config.h). TIMER_timebaseInit() must be running:
+ *  Timer1 stays in normal mode at TIMER_TIMEBASE_HZ.
+ *
+ *    TIMER_CAP_BOTH   the ISR flips ICES1 after every edge, giving high and
+ *                     low times (pulse width, duty). The pin is checked
+ *                     after the flip: an edge that came before it was lost
+ *                     and the next event carries TIMER_CAP_EV_GAP.
+ *    noise_cancel     ICNC1: the edge must be stable for 4 CPU clocks,
+ *                     delaying the capture by 4 clocks.
+ *
+ *  The interrupt must be taken within half a counter period (32768 ticks)
+ *  of the edge for the overflow to be attributed correctly, and before the
+ *  next edge for none to be lost; BENCH reports isr.TIMER1_CAPT_vect, the
+ *  cost per edge.
+ *
+ *  The estimators are plain functions of the events, run in the main loop:
+ *  TIMER_capProcess() drains the ring into a TIMER_CapStats_t window.
+ *  Frequency is reciprocal counting (periods / total time of the window),
+ *  as exact as the tick over a long window; jitter is the RMS deviation of
+ *  the single periods.
+ */
+
+#ifndef TIMER_CAP_INTERFACE_H_
+#define TIMER_CAP_INTERFACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TIMER_config.h"
+
+typedef enum {
+    TIMER_CAP_FALLING = 0,
+    TIMER_CAP_RISING,
+    TIMER_CAP_BOTH              // alternate: pulse widths
+} TIMER_CapEdge_t;
+
+/* TIMER_CapEvent_t.flags */
+#define TIMER_CAP_EV_RISING   0x01
+#define TIMER_CAP_EV_GAP      0x02     // edges were lost just before this one
+
+typedef struct {
+    uint32_t t;                 // TIMER_nowTicks() at the edge
+    uint8_t  flags;             // TIMER_CAP_EV_*
+} TIMER_CapEvent_t;
+
+/* Estimator window. Periods run between edges of the first event's
+   polarity ("lead"); the active time runs from a lead edge to the
+   opposite one. Sums are 32-bit ticks: reset the window well before
+   2^32 ticks (71 min at 1 MHz). */
+typedef struct {
+    uint16_t periods;           // complete periods in the window
+    uint32_t period_sum;        // their total, ticks
+    uint32_t period_min, period_max;
+    uint32_t act_sum;           // active time of the periods that had one
+    uint32_t act_period_sum;    // ... and those periods' total
+    /* internal */
+    uint32_t t_lead, act, ref;
+    int32_t  dev_sum;
+    uint64_t dev_sq_sum;
+    uint8_t  lead, state;
+} TIMER_CapStats_t;
+
+/* ===================== API ===================== */
+void     TIMER_capStart(TIMER_CapEdge_t edge, bool noise_cancel);  // empties the ring
+void     TIMER_capStop(void);
+uint8_t  TIMER_capAvailable(void);                  // events in the ring
+bool     TIMER_capRead(TIMER_CapEvent_t *ev);       // false if empty
+uint16_t TIMER_capOverruns(void);                   // edges dropped on a full ring
+
+/* Estimators */
+void     TIMER_capStatsReset(TIMER_CapStats_t *s);
+void     TIMER_capStatsAdd(TIMER_CapStats_t *s, const TIMER_CapEvent_t *ev);
+uint8_t  TIMER_capProcess(TIMER_CapStats_t *s);     // drains the ring, returns events
+uint32_t TIMER_capFrequencyMilliHz(const TIMER_CapStats_t *s);  // 0 without a period
+uint16_t TIMER_capDutyPermille(const TIMER_CapStats_t *s);      // high time, TIMER_CAP_BOTH
+uint32_t TIMER_capJitterNs(const TIMER_CapStats_t *s);          // RMS period deviation
+
+#endif /* TIMER_CAP_INTERFACE_H_ */
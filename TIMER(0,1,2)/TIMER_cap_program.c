@@ -0,0 +1,237 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> TIMER_cap_program.c <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Layer: MCAL
+// SWC  : TIMER (input capture)
+// Target: ATmega32
+
+#include "TIMER_cap_interface.h"
+#include "TIMER_interface.h"
+#include "TIMER_config.h"
+#include "TIMER_private.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#if TIMER_CAP_ENABLE
+
+#if !TIMER_TIMEBASE_ENABLE
+#error "TIMER_CAP_ENABLE needs TIMER_TIMEBASE_ENABLE (timestamps are time base ticks)"
+#endif
+#if TIMER_CAP_RING < 2 || TIMER_CAP_RING > 128 || (TIMER_CAP_RING & (TIMER_CAP_RING - 1))
+#error "TIMER_CAP_RING must be a power of two, 2..128"
+#endif
+
+#define CAP_MASK  (TIMER_CAP_RING - 1u)
+
+/* TIMER_CapStats_t.state */
+#define ST_LEAD   0x01    // t_lead holds the last lead edge
+#define ST_ACT    0x02    // act holds the active time after it
+
+static TIMER_CapEvent_t cap_ring[TIMER_CAP_RING];
+static volatile uint8_t cap_head;          /* written by the ISR */
+static volatile uint8_t cap_tail;          /* written by TIMER_capRead */
+static volatile uint16_t cap_overruns;
+static uint8_t cap_gap;                    /* TIMER_CAP_EV_GAP for the next event */
+static uint8_t cap_alt;
+
+/* ===== Capture ===== */
+
+void TIMER_capStart(TIMER_CapEdge_t edge, bool noise_cancel)
+{
+    uint8_t sreg = SREG;
+    uint8_t b;
+
+    cli();
+    cap_head = cap_tail = 0;
+    cap_overruns = 0;
+    cap_gap = 0;
+    cap_alt = (edge == TIMER_CAP_BOTH);
+
+    b = TCCR1B & (uint8_t)~((1<<ICNC1) | (1<<ICES1));
+    if (noise_cancel) b |= (1<<ICNC1);
+    /* both edges: start with the one the pin can make next */
+    if (edge == TIMER_CAP_RISING ||
+        (cap_alt && !(ICP1_PINR & (1<<ICP1_PIN)))) b |= (1<<ICES1);
+    TCCR1B = b;
+    TIFR = (1<<ICF1);                 // an edge change can set ICF1
+    TIMSK |= (1<<TICIE1);
+    SREG = sreg;
+}
+
+void TIMER_capStop(void)
+{
+    TIMSK &= (uint8_t)~(1<<TICIE1);
+}
+
+uint8_t TIMER_capAvailable(void)
+{
+    return (uint8_t)((cap_head - cap_tail) & CAP_MASK);
+}
+
+/* single reader: the ISR does not touch the slot until cap_tail moves on */
+bool TIMER_capRead(TIMER_CapEvent_t *ev)
+{
+    uint8_t t = cap_tail;
+
+    if (t == cap_head) return false;
+    *ev = cap_ring[t];
+    cap_tail = (uint8_t)((t + 1) & CAP_MASK);
+    return true;
+}
+
+uint16_t TIMER_capOverruns(void)
+{
+    uint16_t n;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { n = cap_overruns; }
+    return n;
+}
+
+/* ICR1 is the count at the edge. TOV1 still pending with a small ICR1: the
+   counter wrapped before the edge and TIMER1_OVF (lower priority) has not
+   counted it yet. A large ICR1 was latched before the wrap. */
+ISR(TIMER1_CAPT_vect)
+{
+    uint16_t c = ICR1;
+    uint16_t hi = (uint16_t)timer_tb_ovf;
+    uint8_t b = TCCR1B;
+    uint8_t fl = (uint8_t)(((b >> ICES1) & 1) | cap_gap);
+    uint8_t h, n;
+
+    if ((TIFR & (1<<TOV1)) && c < 0x8000) hi++;
+    cap_gap = 0;
+
+    if (cap_alt) {
+        /* arm for the edge away from the pin's level now. A level that is
+           not the one just captured, or one that moves while ICF1 is
+           cleared, means an edge went by uncaptured. */
+        uint8_t lvl = (ICP1_PINR >> ICP1_PIN) & 1;
+        TCCR1B = lvl ? (uint8_t)(b & ~(1<<ICES1)) : (uint8_t)(b | (1<<ICES1));
+        TIFR = (1<<ICF1);
+        if (lvl != (fl & TIMER_CAP_EV_RISING) ||
+            ((ICP1_PINR >> ICP1_PIN) & 1) != lvl) cap_gap = TIMER_CAP_EV_GAP;
+    }
+
+    h = cap_head;
+    n = (uint8_t)((h + 1) & CAP_MASK);
+    if (n == cap_tail) {
+        cap_overruns++;
+        cap_gap = TIMER_CAP_EV_GAP;
+    } else {
+        cap_ring[h].t = ((uint32_t)hi << 16) | c;
+        cap_ring[h].flags = fl;
+        cap_head = n;
+    }
+    TIMER_DISPATCH_T1_CAPT();
+}
+
+/* ===== Estimators ===== */
+
+void TIMER_capStatsReset(TIMER_CapStats_t *s)
+{
+    s->periods = 0;
+    s->period_sum = 0;
+    s->period_min = UINT32_MAX;
+    s->period_max = 0;
+    s->act_sum = 0;
+    s->act_period_sum = 0;
+    s->dev_sum = 0;
+    s->dev_sq_sum = 0;
+    s->lead = 0xFF;                   // taken from the first event
+    s->state = 0;
+}
+
+void TIMER_capStatsAdd(TIMER_CapStats_t *s, const TIMER_CapEvent_t *ev)
+{
+    uint8_t pol = ev->flags & TIMER_CAP_EV_RISING;
+    uint32_t p;
+    int32_t d;
+
+    if (ev->flags & TIMER_CAP_EV_GAP) s->state = 0;   // continuity lost
+    if (s->lead > 1) s->lead = pol;
+
+    if (pol != s->lead) {
+        if (s->state & ST_LEAD) {
+            s->act = ev->t - s->t_lead;
+            s->state |= ST_ACT;
+        }
+        return;
+    }
+
+    if ((s->state & ST_LEAD) && s->periods != UINT16_MAX) {
+        p = ev->t - s->t_lead;
+        s->periods++;
+        s->period_sum += p;
+        if (p < s->period_min) s->period_min = p;
+        if (p > s->period_max) s->period_max = p;
+        if (s->state & ST_ACT) {
+            s->act_sum += s->act;
+            s->act_period_sum += p;
+        }
+        /* deviations from the first period keep the squares small */
+        if (s->periods == 1) s->ref = p;
+        d = (int32_t)(p - s->ref);
+        s->dev_sum += d;
+        s->dev_sq_sum += (uint64_t)((int64_t)d * d);
+    }
+    s->t_lead = ev->t;
+    s->state = ST_LEAD;
+}
+
+uint8_t TIMER_capProcess(TIMER_CapStats_t *s)
+{
+    TIMER_CapEvent_t ev;
+    uint8_t n = 0;
+
+    while (TIMER_capRead(&ev)) {
+        TIMER_capStatsAdd(s, &ev);
+        n++;
+    }
+    return n;
+}
+
+uint32_t TIMER_capFrequencyMilliHz(const TIMER_CapStats_t *s)
+{
+    if (!s->period_sum) return 0;
+    return (uint32_t)(((uint64_t)s->periods * (TIMER_TIMEBASE_HZ * 1000ULL) + s->period_sum / 2)
+                      / s->period_sum);
+}
+
+/* the active time is the high time when periods start on rising edges */
+uint16_t TIMER_capDutyPermille(const TIMER_CapStats_t *s)
+{
+    uint16_t d;
+
+    if (!s->act_period_sum) return 0;
+    d = (uint16_t)(((uint64_t)s->act_sum * 1000u + s->act_period_sum / 2) / s->act_period_sum);
+    return (s->lead == 1) ? d : (uint16_t)(1000u - d);
+}
+
+static uint32_t _cap_isqrt(uint64_t v)
+{
+    uint64_t r = 0, bit = (uint64_t)1 << 62;
+
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+/* variance in ticks^2 scaled by 2^16, so the root has 8 fraction bits */
+uint32_t TIMER_capJitterNs(const TIMER_CapStats_t *s)
+{
+    int64_t mean_q8;
+    uint64_t var_q16;
+
+    if (s->periods < 2) return 0;
+    mean_q8 = ((int64_t)s->dev_sum * 256) / s->periods;
+    var_q16 = (s->dev_sq_sum << 16) / s->periods;
+    var_q16 = (var_q16 > (uint64_t)(mean_q8 * mean_q8)) ? var_q16 - (uint64_t)(mean_q8 * mean_q8) : 0;
+    return (uint32_t)((uint64_t)_cap_isqrt(var_q16) * 1000000000ULL / (TIMER_TIMEBASE_HZ * 256ULL));
+}
+
+#endif
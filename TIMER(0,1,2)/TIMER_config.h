@@ -0,0 +1,188 @@
+	/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    TIMER_config.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Author : Ahmed Shaban
+ *  Layer  : MCAL
+ *  SWC    : TIMER
+ *
+ */
+
+#ifndef TIMER_CONFIG_H_
+#define TIMER_CONFIG_H_
+
+/* You can place app-wide defaults here if you like. They are not enforced by code,
+   but useful as documentation or compile-time selection. */
+
+#define TIMER_DEFAULT_MODE         TIMER_MODE_FAST_PWM
+#define TIMER0_DEFAULT_CLOCK       TIMER01_CLK_64
+#define TIMER1_DEFAULT_CLOCK       TIMER01_CLK_64
+#define TIMER2_DEFAULT_CLOCK       TIMER2_CLK_64
+
+/* Default OC modes (non-inverting for PWM) */
+#define TIMER_DEFAULT_OC_MODE_A    TIMER_OC_CLEAR
+#define TIMER_DEFAULT_OC_MODE_B    TIMER_OC_CLEAR
+
+#ifndef F_CPU
+#define F_CPU                      8000000UL
+#endif
+
+/* ===================== Interrupt Dispatch ===================== */
+/* What each Timer0/1/2 vector runs for the application:
+     TIMER_ISR_NONE     the driver does not define the vector (unless one of
+                        its services needs it): write your own ISR()
+     TIMER_ISR_RUNTIME  the callback set with TIMER_setCallback(), if any.
+                        An indirect call: the vector saves every
+                        call-clobbered register
+     TIMER_ISR_STATIC   the function TIMER_ISR_HANDLER_<vect> names, a
+                        static inline in the header TIMER_ISR_HANDLERS_H,
+                        compiled into the vector body
+   A vector a driver service uses (time base, shadow commit, software
+   timers, capture) runs the service first and then this handler.
+   All NONE by default: with the services below also off, the driver
+   defines no vector. Overridable from the build
+   (-DTIMER_ISR_T0_OVF=TIMER_ISR_STATIC). */
+#define TIMER_ISR_NONE             0
+#define TIMER_ISR_RUNTIME          1
+#define TIMER_ISR_STATIC           2
+
+#ifndef TIMER_ISR_T0_OVF
+#define TIMER_ISR_T0_OVF           TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T0_COMP
+#define TIMER_ISR_T0_COMP          TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T1_OVF
+#define TIMER_ISR_T1_OVF           TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T1_COMPA
+#define TIMER_ISR_T1_COMPA         TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T1_COMPB
+#define TIMER_ISR_T1_COMPB         TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T1_CAPT
+#define TIMER_ISR_T1_CAPT          TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T2_OVF
+#define TIMER_ISR_T2_OVF           TIMER_ISR_NONE
+#endif
+#ifndef TIMER_ISR_T2_COMP
+#define TIMER_ISR_T2_COMP          TIMER_ISR_NONE
+#endif
+
+/* For TIMER_ISR_STATIC the driver includes TIMER_ISR_HANDLERS_H, which
+   defines the handlers and names them, e.g. in "app_timer_isr.h":
+     static inline void app_on_t0_ovf(void) { ... }
+     #define TIMER_ISR_HANDLER_T0_OVF    app_on_t0_ovf */
+#ifndef TIMER_ISR_HANDLERS_H
+#define TIMER_ISR_HANDLERS_H       "app_timer_isr.h"
+#endif
+
+/* ===================== Time Base (Timer1) ===================== */
+/* TIMER_timebaseInit() runs Timer1 free in normal mode at F_CPU / DIV and
+   its overflow interrupt extends TCNT1 to 48 bits. The driver then owns
+   TIMER1_OVF_vect, and Timer1 is not available for PWM / ADC sampling.
+   Off by default. */
+#ifndef TIMER_TIMEBASE_ENABLE
+#define TIMER_TIMEBASE_ENABLE      0
+#endif
+#define TIMER_TIMEBASE_DIV         8        /* 1, 8, 64, 256 or 1024 */
+
+/* ===================== Dithered PWM ===================== */
+/* Bit n set: Timer n's PWM channels can take a 16-bit duty
+   (TIMER_ditherSet). The overflow interrupt then adds a sigma-delta step
+   per dithered channel. Not with TIMER_SHADOW_TIMERS on the same timer
+   (both write OCR there), nor on the TIMER_SPWM_HW_TIMER, nor on Timer1
+   while it is the time base. */
+#ifndef TIMER_DITHER_TIMERS
+#define TIMER_DITHER_TIMERS        0x00
+#endif
+
+/* ===================== Group Start ===================== */
+/* TIMER_startGroup() resets the prescalers and releases the timers with
+   back-to-back stores of TCCR0, TCCR1B and TCCR2. A prescaled timer makes
+   its first count DIV cycles after the reset, in step with the others.
+   At clk/1 each store starts its timer at once, so the counters are
+   preloaded with the distance to the last store, TIMER_GROUP_STORE_CYCLES
+   per store (1: OUT). TIMER_groupSkewTest() measures what remains. */
+#ifndef TIMER_GROUP_STORE_CYCLES
+#define TIMER_GROUP_STORE_CYCLES   1
+#endif
+
+/* ===================== Input Capture (TIMER_cap) ===================== */
+/* TIMER_capStart() timestamps ICP1 (PD6) edges on the time base, so it
+   needs TIMER_TIMEBASE_ENABLE and owns TIMER1_CAPT_vect. Edges queue in a
+   ring of TIMER_CAP_RING entries (power of two, 2..128, 5 bytes each);
+   a full ring drops edges and marks the next one as following a gap.
+   Off by default. */
+#ifndef TIMER_CAP_ENABLE
+#define TIMER_CAP_ENABLE           0
+#endif
+#define TIMER_CAP_RING             32
+
+/* ===================== Shadow Registers ===================== */
+/* Bit n set: Timer n gets the staged commit path (TIMER_stage* /
+   TIMER_commit). The driver then owns that timer's overflow vector and
+   its compare vector (TIMER0_COMP, TIMER1_COMPA, TIMER2_COMP; used in CTC
+   mode only), so the bit cannot be set for the timer the software timers
+   run on. */
+#ifndef TIMER_SHADOW_TIMERS
+#define TIMER_SHADOW_TIMERS        0x00
+#endif
+
+/* ===================== Software Timers (TIMER_sw) ===================== */
+
+/* Tick mode (TIMER_SW_TICKLESS 0): TIMER_SW_HW_TIMER 0 or 2 runs in CTC
+   mode and interrupts every tick at TIMER_SW_TICK_HZ; 255 (default) leaves
+   the hardware alone, call TIMER_swTick() from your own periodic ISR.
+   Tickless (TIMER_SW_TICKLESS 1): TIMER_SW_HW_TIMER 0, 1 or 2 runs free and
+   its compare unit is programmed for the next deadline only. A tick is one
+   timer count, so TIMER_SW_TICK_HZ must be F_CPU / prescaler; the overflow
+   interrupt (every 2^8 or 2^16 counts) extends the count. On Timer1 with
+   TIMER_TIMEBASE_ENABLE the time base is that count, so TIMER_SW_TICK_HZ
+   must be F_CPU / TIMER_TIMEBASE_DIV. Timer1 is also the default
+   ADC_SAMPLING_TIMER. The chosen timer cannot be in TIMER_SHADOW_TIMERS. */
+#ifndef TIMER_SW_TICKLESS
+#define TIMER_SW_TICKLESS          0
+#endif
+#if TIMER_SW_TICKLESS
+#ifndef TIMER_SW_HW_TIMER
+#define TIMER_SW_HW_TIMER          1
+#endif
+#define TIMER_SW_TICK_HZ           (F_CPU / TIMER_TIMEBASE_DIV)
+#else
+#ifndef TIMER_SW_HW_TIMER
+#define TIMER_SW_HW_TIMER          255
+#endif
+#define TIMER_SW_TICK_HZ           1000UL
+#endif
+
+/* Tickless: CPU cycles from reading the counter to the compare being
+   armed. Deadlines closer than this are waited for in the ISR instead. */
+#define TIMER_SW_LEAD_CYCLES       80
+
+/* Wheel geometry: TIMER_SW_LEVELS levels of 2^TIMER_SW_WHEEL_BITS slots,
+   one pointer per slot. Delays up to 2^(bits * levels) ticks are placed
+   directly; longer ones are parked in the top level and re-placed when it
+   comes round. 4 x 4 bits: 64 slots, 128 bytes, 65536 ticks. */
+#define TIMER_SW_WHEEL_BITS        4
+#define TIMER_SW_LEVELS            4
+
+/* ===================== Software PWM (TIMER_spwm) ===================== */
+/* TIMER_SPWM_HW_TIMER 0 or 2 runs free at F_CPU / TIMER_SPWM_DIV and its
+   compare interrupt walks the edge schedule: 256 counts per period, so
+   f = F_CPU / (DIV * 256), 488 Hz at 8 MHz / 64. 255 (default): no
+   software PWM.
+   The engine owns that timer's compare vector. A count must be longer
+   than one edge in the ISR (about 40 cycles): DIV >= 64.
+   TIMER_SPWM_PORTS: ports the ISR writes (bit 0 PORTA .. bit 3 PORTD);
+   drop the ports without channels, each costs a read-modify-write per
+   edge. */
+#ifndef TIMER_SPWM_HW_TIMER
+#define TIMER_SPWM_HW_TIMER        255
+#endif
+#define TIMER_SPWM_DIV             64
+#define TIMER_SPWM_CHANNELS        24
+#define TIMER_SPWM_PORTS           0x0F
+
+#endif /* TIMER_CONFIG_H_ */
\ No newline at end of file
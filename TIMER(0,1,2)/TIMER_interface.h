@@ -0,0 +1,491 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    TIMER_interface.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Author : Ahmed Shaban
+ *  Layer  : MCAL
+ *  SWC    : TIMER
+ *
+ */
+
+#ifndef TIMER_INTERFACE_H_
+#define TIMER_INTERFACE_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "TIMER_config.h"
+
+/* ===================== Timer Selection ===================== */
+typedef enum {
+    TIMER_ID_0 = 0,
+    TIMER_ID_1,
+    TIMER_ID_2
+} TIMER_ID_t;
+
+/* ===================== Channels (where applicable) ===================== */
+typedef enum {
+    TIMER_CH_A = 0,   // Timer0: OC0, Timer1: OC1A, Timer2: OC2
+    TIMER_CH_B        // Only valid for Timer1 (OC1B)
+} TIMER_Channel_t;
+
+/* ===================== Operating Modes ===================== */
+typedef enum {
+    TIMER_MODE_NORMAL = 0,   // Overflow mode
+    TIMER_MODE_PHASE_PWM,    // Phase Correct PWM
+    TIMER_MODE_CTC,          // Clear Timer on Compare Match
+    TIMER_MODE_FAST_PWM,     // Fast PWM
+    /* TOP = ICR1 (top_icr1): any frequency, up to 16-bit resolution.
+       Timer1 only; Timer0/2 fall back to the fixed-TOP mode of the same slope */
+    TIMER_MODE_PFC_PWM_ICR1,   // Phase & frequency correct, WGM 8
+    TIMER_MODE_PHASE_PWM_ICR1, // Phase correct, WGM 10
+    TIMER_MODE_FAST_PWM_ICR1   // Fast PWM, WGM 14
+} TIMER_Mode_t;
+
+/* ===================== Compare Output Modes (COM bits) ===================== */
+/*
+   - Non-PWM modes: DISCONNECTED / TOGGLE / CLEAR / SET
+   - PWM modes: DISCONNECTED / NON-INVERTING (CLEAR) / INVERTING (SET)
+*/
+typedef enum {
+    TIMER_OC_DISCONNECTED = 0,
+    TIMER_OC_TOGGLE,
+    TIMER_OC_CLEAR,
+    TIMER_OC_SET
+} TIMER_OCMode_t;
+
+/* ===================== Clock / Prescaler Selection ===================== */
+/* Timer0 & Timer1 share prescalers */
+typedef enum {
+    TIMER01_CLK_OFF = 0,  // Stopped
+    TIMER01_CLK_1,
+    TIMER01_CLK_8,
+    TIMER01_CLK_64,
+    TIMER01_CLK_256,
+    TIMER01_CLK_1024,
+    TIMER01_EXT_FALL,
+    TIMER01_EXT_RISE
+} TIMER01_Clock_t;
+
+/* Timer2 has different prescalers on ATmega32 */
+typedef enum {
+    TIMER2_CLK_OFF = 0,
+    TIMER2_CLK_1,
+    TIMER2_CLK_8,
+    TIMER2_CLK_32,
+    TIMER2_CLK_64,
+    TIMER2_CLK_128,
+    TIMER2_CLK_256,
+    TIMER2_CLK_1024
+} TIMER2_Clock_t;
+
+/* ===================== Configuration Structure ===================== */
+typedef struct {
+    TIMER_ID_t id;              // Timer0, Timer1, or Timer2
+    TIMER_Mode_t mode;          // Normal, CTC, Fast PWM, Phase PWM
+    uint8_t clock_sel;          // Use TIMER01_Clock_t or TIMER2_Clock_t
+    TIMER_OCMode_t oc_mode_A;   // OC0 / OC1A / OC2
+    TIMER_OCMode_t oc_mode_B;   // Only for Timer1 (OC1B); ignored for Timer0/2
+    uint16_t tcnt_init;         // Counter preload
+    uint16_t ocrA_init;         // OCR0 / OCR1A / OCR2 initial
+    uint16_t ocrB_init;         // OCR1B initial (Timer1 only)
+    uint16_t top_icr1;          // ICR1 (TOP) for the *_ICR1 modes (Timer1)
+    uint8_t int_ovf_enable;     // Overflow interrupt enable
+    uint8_t int_ocA_enable;     // Compare A interrupt enable
+    uint8_t int_ocB_enable;     // Compare B interrupt enable
+    uint8_t configure_oc_pins;  // Auto configure OC pins
+} TIMER_Config_t;
+
+/* ===================== API ===================== */
+void     TIMER_init(const TIMER_Config_t *cfg);
+void     TIMER_start(TIMER_ID_t id, uint8_t clock_sel);
+void     TIMER_stop(TIMER_ID_t id);
+void     TIMER_setMode(TIMER_ID_t id, TIMER_Mode_t mode);
+void     TIMER_setOCMode(TIMER_ID_t id, TIMER_Channel_t ch, TIMER_OCMode_t mode);
+void     TIMER_setCounter(TIMER_ID_t id, uint16_t value);
+uint16_t TIMER_getCounter(TIMER_ID_t id);
+void     TIMER_setCompare(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t value);
+void     TIMER_setDutyRaw(TIMER_ID_t id, TIMER_Channel_t ch, uint8_t duty_0_255);
+void     TIMER_enableInterrupts(TIMER_ID_t id, uint8_t en_ovf, uint8_t en_ocA, uint8_t en_ocB);
+
+/* ===================== Compile-time Specialized Access ===================== */
+/*
+   With a constant id the start/stop/counter/compare/duty calls above are
+   resolved here at compile time: no switch and no call. An 8-bit compare
+   or duty update is a single OUT to OCR0 / OCR2; Timer1 16-bit writes go
+   through the shared TEMP byte inside an ATOMIC_BLOCK. A variable id calls
+   the out-of-line function, which is a thin wrapper over the same code;
+   (TIMER_setCompare)(id, ch, v) forces it.
+   TIMER0_* / TIMER1_* / TIMER2_* name the timer for control-loop code.
+*/
+
+/* Timer1 16-bit registers share one TEMP byte: an ISR touching any of them
+   between the two byte accesses corrupts the value */
+static inline __attribute__((always_inline))
+uint16_t _timer_read16(volatile uint16_t *reg)
+{
+    uint16_t v;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { v = *reg; }
+    return v;
+}
+
+static inline __attribute__((always_inline))
+void _timer_write16(volatile uint16_t *reg, uint16_t v)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *reg = v; }
+}
+
+/* one write: the clock bits never pass through "stopped" */
+static inline __attribute__((always_inline))
+void _timer_start(TIMER_ID_t id, uint8_t clock_sel)
+{
+    switch (id) {
+    case TIMER_ID_0: TCCR0  = (uint8_t)((TCCR0  & ~((1<<CS02)|(1<<CS01)|(1<<CS00))) | (clock_sel & 0x07)); break;
+    case TIMER_ID_1: TCCR1B = (uint8_t)((TCCR1B & ~((1<<CS12)|(1<<CS11)|(1<<CS10))) | (clock_sel & 0x07)); break;
+    case TIMER_ID_2: TCCR2  = (uint8_t)((TCCR2  & ~((1<<CS22)|(1<<CS21)|(1<<CS20))) | (clock_sel & 0x07)); break;
+    }
+}
+
+static inline __attribute__((always_inline))
+void _timer_stop(TIMER_ID_t id)
+{
+    switch (id) {
+    case TIMER_ID_0: TCCR0  &= (uint8_t)~((1<<CS02)|(1<<CS01)|(1<<CS00)); break;
+    case TIMER_ID_1: TCCR1B &= (uint8_t)~((1<<CS12)|(1<<CS11)|(1<<CS10)); break;
+    case TIMER_ID_2: TCCR2  &= (uint8_t)~((1<<CS22)|(1<<CS21)|(1<<CS20)); break;
+    }
+}
+
+static inline __attribute__((always_inline))
+void _timer_setCounter(TIMER_ID_t id, uint16_t value)
+{
+    switch (id) {
+    case TIMER_ID_0: TCNT0 = (uint8_t)value; break;
+    case TIMER_ID_1: _timer_write16(&TCNT1, value); break;
+    case TIMER_ID_2: TCNT2 = (uint8_t)value; break;
+    }
+}
+
+static inline __attribute__((always_inline))
+uint16_t _timer_getCounter(TIMER_ID_t id)
+{
+    switch (id) {
+    case TIMER_ID_0: return TCNT0;
+    case TIMER_ID_1: return _timer_read16(&TCNT1);
+    case TIMER_ID_2: return TCNT2;
+    }
+    return 0;
+}
+
+static inline __attribute__((always_inline))
+void _timer_setCompare(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t value)
+{
+    switch (id) {
+    case TIMER_ID_0: OCR0 = (uint8_t)value; break;
+    case TIMER_ID_1: _timer_write16((ch == TIMER_CH_A) ? &OCR1A : &OCR1B, value); break;
+    case TIMER_ID_2: OCR2 = (uint8_t)value; break;
+    }
+}
+
+/* For 8-bit Fast/Phase PWM, OCRx = duty directly. For Timer1 in the 8-bit
+   PWM modes, duty goes into OCR1x[7:0]; in the ICR1 modes it is scaled to
+   TOP: (TOP + 1) * duty / 256. */
+static inline __attribute__((always_inline))
+void _timer_setDutyRaw(TIMER_ID_t id, TIMER_Channel_t ch, uint8_t duty_0_255)
+{
+    uint16_t v = duty_0_255;
+
+    switch (id) {
+    case TIMER_ID_0: OCR0 = duty_0_255; break;
+    case TIMER_ID_1:
+        if (TCCR1B & (1<<WGM13))
+            v = (uint16_t)(((uint32_t)_timer_read16(&ICR1) + 1) * duty_0_255 >> 8);
+        _timer_write16((ch == TIMER_CH_A) ? &OCR1A : &OCR1B, v);
+        break;
+    case TIMER_ID_2: OCR2 = duty_0_255; break;
+    }
+}
+
+#define TIMER_start(id, clock_sel)  (__builtin_constant_p(id) ? _timer_start((id), (clock_sel)) \
+                                                              : (TIMER_start)((id), (clock_sel)))
+#define TIMER_stop(id)              (__builtin_constant_p(id) ? _timer_stop(id) : (TIMER_stop)(id))
+#define TIMER_setCounter(id, v)     (__builtin_constant_p(id) ? _timer_setCounter((id), (v)) \
+                                                              : (TIMER_setCounter)((id), (v)))
+#define TIMER_getCounter(id)        (__builtin_constant_p(id) ? _timer_getCounter(id) : (TIMER_getCounter)(id))
+#define TIMER_setCompare(id, ch, v) (__builtin_constant_p(id) ? _timer_setCompare((id), (ch), (v)) \
+                                                              : (TIMER_setCompare)((id), (ch), (v)))
+#define TIMER_setDutyRaw(id, ch, d) (__builtin_constant_p(id) ? _timer_setDutyRaw((id), (ch), (d)) \
+                                                              : (TIMER_setDutyRaw)((id), (ch), (d)))
+
+static inline void     TIMER0_start(uint8_t clock_sel)   { _timer_start(TIMER_ID_0, clock_sel); }
+static inline void     TIMER0_setCounter(uint8_t v)      { TCNT0 = v; }
+static inline uint8_t  TIMER0_getCounter(void)           { return TCNT0; }
+static inline void     TIMER0_setCompare(uint8_t v)      { OCR0 = v; }
+static inline void     TIMER0_setDutyRaw(uint8_t d)      { OCR0 = d; }
+
+static inline void     TIMER1_start(uint8_t clock_sel)   { _timer_start(TIMER_ID_1, clock_sel); }
+static inline void     TIMER1_setCounter(uint16_t v)     { _timer_write16(&TCNT1, v); }
+static inline uint16_t TIMER1_getCounter(void)           { return _timer_read16(&TCNT1); }
+static inline void     TIMER1_setCompareA(uint16_t v)    { _timer_write16(&OCR1A, v); }
+static inline void     TIMER1_setCompareB(uint16_t v)    { _timer_write16(&OCR1B, v); }
+static inline void     TIMER1_setDutyRawA(uint8_t d)     { _timer_setDutyRaw(TIMER_ID_1, TIMER_CH_A, d); }
+static inline void     TIMER1_setDutyRawB(uint8_t d)     { _timer_setDutyRaw(TIMER_ID_1, TIMER_CH_B, d); }
+
+static inline void     TIMER2_start(uint8_t clock_sel)   { _timer_start(TIMER_ID_2, clock_sel); }
+static inline void     TIMER2_setCounter(uint8_t v)      { TCNT2 = v; }
+static inline uint8_t  TIMER2_getCounter(void)           { return TCNT2; }
+static inline void     TIMER2_setCompare(uint8_t v)      { OCR2 = v; }
+static inline void     TIMER2_setDutyRaw(uint8_t d)      { OCR2 = d; }
+
+/* ===================== Interrupt Dispatch ===================== */
+/*
+   The driver defines the Timer0/1/2 vectors its enabled services use and
+   those TIMER_ISR_<vect> in TIMER_config.h asks for: per vector a
+   callback set here at run time, a handler bound at compile time (inlined
+   into the vector, no indirect call and only the registers it uses
+   saved), or none (the default). Callbacks run with interrupts off, after
+   any driver service on the same vector; they are ignored for vectors not
+   set to TIMER_ISR_RUNTIME, and TIMER_setCallback() exists only if one is.
+
+   Cost: bench_baseline_sim.txt records isr.TIMER0_OVF_vect_static 11 and
+   isr.TIMER1_COMPB_vect_runtime 11 SIM cycles, a delta of 0, because the
+   model times register accesses and not the saves the indirect call
+   forces. On avr-gcc the runtime vector also pushes and pops the 12
+   call-clobbered registers and loads and icalls the pointer: about 55
+   cycles more, an estimate until 'make -C BENCH bench-baseline' records
+   both on the reference toolchain.
+*/
+typedef enum {
+    TIMER_VECT_T0_OVF = 0,
+    TIMER_VECT_T0_COMP,
+    TIMER_VECT_T1_OVF,
+    TIMER_VECT_T1_COMPA,
+    TIMER_VECT_T1_COMPB,
+    TIMER_VECT_T1_CAPT,
+    TIMER_VECT_T2_OVF,
+    TIMER_VECT_T2_COMP,
+    TIMER_VECT_COUNT
+} TIMER_Vector_t;
+
+typedef void (*TIMER_Callback_t)(void);
+
+void     TIMER_setCallback(TIMER_Vector_t v, TIMER_Callback_t cb);   // NULL: none
+
+/* ===================== PWM Frequency Solver ===================== */
+/*
+   Timer1: the smallest prescaler whose TOP fits 16 bits, i.e. the most
+   counts (resolution) per period, in an ICR1 mode (WGM 14, or 8/10 if the
+   timer already runs dual slope). Timer0/2: TOP is fixed at 0xFF, only
+   the prescaler closest to hz is chosen, 8 bits.
+     fast PWM:    f = F_CPU / (N * (TOP + 1))
+     dual slope:  f = F_CPU / (2 * N * TOP)
+   With constant id and hz the solution is folded by the compiler and only
+   the register writes remain; otherwise TIMER_pwmSolve runs.
+*/
+typedef struct {
+    uint32_t hz;          // achieved frequency, 0: out of range
+    uint16_t top;         // ICR1 (Timer1), 0xFF (Timer0/2)
+    uint8_t  clock_sel;   // TIMER01_Clock_t / TIMER2_Clock_t
+    uint8_t  bits;        // resolution, floor(log2(TOP + 1))
+    uint8_t  dual;        // dual slope (phase correct) timing
+} TIMER_PwmSetting_t;
+
+TIMER_PwmSetting_t TIMER_pwmSolve(TIMER_ID_t id, uint32_t hz, uint8_t dual);
+TIMER_PwmSetting_t TIMER_pwmApply(TIMER_ID_t id, TIMER_PwmSetting_t s);
+uint8_t            TIMER_pwmDualSlope(TIMER_ID_t id);   // current mode counts up and down
+
+/* counts per period at divider n, rounded */
+static inline __attribute__((always_inline))
+uint32_t _timer_pwm_counts(uint32_t hz, uint16_t n, uint8_t dual)
+{
+    uint32_t step = (uint32_t)n * hz * (dual ? 2u : 1u);
+    return (F_CPU + step / 2) / step;
+}
+
+/* fixed period: keep divider n (clock code cs) if closer to hz than s */
+static inline __attribute__((always_inline))
+void _timer_pwm_pick(TIMER_PwmSetting_t *s, uint32_t hz, uint16_t n, uint8_t cs)
+{
+    uint32_t per = s->dual ? 510u : 256u;
+    uint32_t f = (F_CPU + (uint32_t)n * per / 2) / ((uint32_t)n * per);
+    uint32_t e = (f > hz) ? f - hz : hz - f;
+    uint32_t be = (s->hz > hz) ? s->hz - hz : hz - s->hz;
+    if (!s->hz || e < be) { s->hz = f; s->clock_sel = cs; }
+}
+
+/* Timer1: take divider n (clock code cs) if TOP fits */
+static inline __attribute__((always_inline))
+uint8_t _timer_pwm_fit16(TIMER_PwmSetting_t *s, uint32_t hz, uint16_t n, uint8_t cs)
+{
+    uint32_t c = _timer_pwm_counts(hz, n, s->dual);
+    uint32_t top = s->dual ? c : c - 1;
+    if (c == 0 || top > 0xFFFFUL) return 0;
+    if (top < 3) return 1;                  /* too fast for 2 bits: give up */
+    s->top = (uint16_t)top;
+    s->clock_sel = cs;
+    s->hz = (F_CPU + (uint32_t)n * c * (s->dual ? 2u : 1u) / 2) / ((uint32_t)n * c * (s->dual ? 2u : 1u));
+    s->bits = (uint8_t)(8 * sizeof(unsigned long) - 1 - __builtin_clzl((unsigned long)top + 1));
+    return 1;
+}
+
+static inline __attribute__((always_inline))
+TIMER_PwmSetting_t _timer_pwm_solve(TIMER_ID_t id, uint32_t hz, uint8_t dual)
+{
+    TIMER_PwmSetting_t s = { 0, 0, 0, 0, dual };
+
+    if (hz == 0) return s;
+    if (id == TIMER_ID_1) {
+        (void)(_timer_pwm_fit16(&s, hz, 1, TIMER01_CLK_1) || _timer_pwm_fit16(&s, hz, 8, TIMER01_CLK_8) ||
+               _timer_pwm_fit16(&s, hz, 64, TIMER01_CLK_64) || _timer_pwm_fit16(&s, hz, 256, TIMER01_CLK_256) ||
+               _timer_pwm_fit16(&s, hz, 1024, TIMER01_CLK_1024));
+        return s;
+    }
+    if (id == TIMER_ID_0) {
+        _timer_pwm_pick(&s, hz, 1, TIMER01_CLK_1);
+        _timer_pwm_pick(&s, hz, 8, TIMER01_CLK_8);
+        _timer_pwm_pick(&s, hz, 64, TIMER01_CLK_64);
+        _timer_pwm_pick(&s, hz, 256, TIMER01_CLK_256);
+        _timer_pwm_pick(&s, hz, 1024, TIMER01_CLK_1024);
+    } else {
+        _timer_pwm_pick(&s, hz, 1, TIMER2_CLK_1);
+        _timer_pwm_pick(&s, hz, 8, TIMER2_CLK_8);
+        _timer_pwm_pick(&s, hz, 32, TIMER2_CLK_32);
+        _timer_pwm_pick(&s, hz, 64, TIMER2_CLK_64);
+        _timer_pwm_pick(&s, hz, 128, TIMER2_CLK_128);
+        _timer_pwm_pick(&s, hz, 256, TIMER2_CLK_256);
+        _timer_pwm_pick(&s, hz, 1024, TIMER2_CLK_1024);
+    }
+    s.top = 0xFF;
+    s.bits = 8;
+    return s;
+}
+
+/* Sets the prescaler and TOP (Timer1: ICR1, switching to WGM 14 unless the
+   timer already runs in WGM 8/10). OCR values are left alone: rescale the
+   duty against the returned TOP. For a running power stage, stage the TOP
+   with TIMER_stageTop/TIMER_commit instead (WGM 8 or 14). */
+static inline TIMER_PwmSetting_t TIMER_setPwmFrequency(TIMER_ID_t id, uint32_t hz)
+{
+    if (__builtin_constant_p(id) && __builtin_constant_p(hz))
+        return TIMER_pwmApply(id, TIMER_pwmDualSlope(id) ? _timer_pwm_solve(id, hz, 1)
+                                                         : _timer_pwm_solve(id, hz, 0));
+    return TIMER_pwmApply(id, TIMER_pwmSolve(id, hz, TIMER_pwmDualSlope(id)));
+}
+
+/* ===================== Shadow Registers (glitch-free updates) ===================== */
+/*
+   Stage any number of compare values (and the Timer1 ICR1 TOP), then
+   TIMER_commit(): the overflow / TOP interrupt copies the whole set into
+   the registers, so no period ever runs with half of it.
+     - Normal / CTC: written at the start of the next period, all at once.
+     - PWM: compare values go in at the next TOP and take effect through
+       the hardware buffer one period later; a staged ICR1 (unbuffered) is
+       written one interrupt after them, in the period they become active.
+     - WGM 10 loads the OCRs at TOP but interrupts at BOTTOM, so a new TOP
+       would meet the new duties half a period late: TIMER_stageTop refuses
+       it (returns 0). Use WGM 8, where both happen at BOTTOM.
+   Staging again before the commit completes is fine: TIMER_commit merges
+   the new values into the pending set. Only timers in TIMER_SHADOW_TIMERS.
+*/
+typedef void (*TIMER_CommitCallback_t)(TIMER_ID_t id);
+
+void    TIMER_stageCompare(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t value);
+uint8_t TIMER_stageTop(TIMER_ID_t id, uint16_t top);   // Timer1: ICR1, 0: not staged
+void    TIMER_commit(TIMER_ID_t id);
+uint8_t TIMER_commitPending(TIMER_ID_t id);             // 0 once the set is in the registers
+uint8_t TIMER_commitCount(TIMER_ID_t id);               // completed commits, wraps
+void    TIMER_setCommitCallback(TIMER_ID_t id, TIMER_CommitCallback_t cb);  // ISR context
+
+/* ===================== Dithered PWM ===================== */
+/*
+   A 16-bit duty on a hardware PWM channel: the 16-bit counterpart of
+   TIMER_setDutyRaw, mean OCR = duty * (TOP + 1) / 65536. The integer part
+   goes to OCR, the fraction (8 bits) into a first-order sigma-delta
+   accumulator that the overflow interrupt steps once per period, raising
+   OCR by one count in frac / 256 of the periods. Resolution is the
+   timer's plus 8 bits, up to the 16 bits of the duty: 16 on the 8-bit
+   timers. The ripple is one count, its slowest pattern repeats at
+   F_PWM / 256: filter below that.
+   The ISR cost is fixed per dithered channel: an 8-bit add and an OCR
+   write. BENCH reports isr.TIMER2_OVF_vect_dither.
+   The timer is set up for PWM beforehand (TIMER_init); TIMER_ditherSet
+   returns 0 in normal and CTC mode, where the OCR belongs to the software
+   timers or the application. TOP is read at TIMER_ditherSet (Timer1: ICR1
+   in the ICR1 modes, else 0xFF), so set the duty again after a frequency
+   change. At TOP the fraction is dropped. Only timers in
+   TIMER_DITHER_TIMERS, which cannot include the software PWM timer.
+*/
+#define TIMER_DITHER_12(d12)   ((uint16_t)((d12) << 4))    // 12-bit duty -> 16-bit
+
+uint8_t TIMER_ditherSet(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t duty);  // 1: dithering
+void    TIMER_ditherStop(TIMER_ID_t id, TIMER_Channel_t ch);                 // OCR keeps the integer part
+
+/* ===================== Synchronized Start ===================== */
+/*
+   TIMER_startGroup stops the selected timers, preloads their counters with
+   the phase offsets, resets the prescalers (SFIOR PSR10 for Timer0/1,
+   PSR2 for Timer2) and releases all of them in one straight-line burst,
+   interrupts off. Timers on the same divider then count in lockstep:
+   TCNTn - TCNTm stays tcnt[n] - tcnt[m] (until a TOP differs). Mode and
+   compare outputs are set beforehand with TIMER_init (clock OFF).
+     - The ATmega32 cannot hold a prescaler in reset, so lockstep relies
+       on the release stores landing within one prescaled count; at clk/1
+       the counters are compensated by TIMER_GROUP_STORE_CYCLES.
+     - The reset also restarts the prescaler of an unselected running
+       timer on it (Timer0 and Timer1 share PSR10): one short count.
+     - Timer1 as the time base would be stepped: leave it out.
+   TIMER_groupSkewTest is a start-up self-test: it starts all three at
+   clk/1 with equal offsets and returns TCNTn - TCNT0 in CPU cycles
+   (read in both orders, so the read spacing cancels). Timers are left
+   stopped, counters 0, in their previous modes; their interrupt flags
+   are cleared. Run it before the outputs are live. A running time base
+   is left counting (its prescaler restarts once, as above) and Timer1 is
+   skipped: the returned TIMER_GROUP_* mask says which timers were
+   measured, skew[1] is 0 without Timer1.
+*/
+#define TIMER_GROUP_T0    0x01
+#define TIMER_GROUP_T1    0x02
+#define TIMER_GROUP_T2    0x04
+#define TIMER_GROUP_ALL   0x07
+
+typedef struct {
+    uint8_t  clock_sel[3];      // per timer: TIMER01_Clock_t / TIMER2_Clock_t
+    uint16_t tcnt[3];           // counter at release: phase offset, counts
+} TIMER_Group_t;
+
+void TIMER_startGroup(uint8_t mask, const TIMER_Group_t *g);
+uint8_t TIMER_groupSkewTest(int8_t skew[3]);           // skew[0] = 0; timers measured
+
+/* ===================== Time Base (Timer1) ===================== */
+/*
+   Monotonic count of Timer1 clocks (TIMER_TIMEBASE_HZ) since the time base
+   started. Reads are race free: TCNT1 is read with interrupts off (its high
+   byte goes through the shared TEMP register) and an overflow that is
+   pending but not yet counted by the ISR is added in.
+   TIMER_nowTicks wraps after 2^32 clocks (71 min at 1 MHz); unsigned
+   differences stay correct across the wrap. TIMER_nowTicks64 carries 48
+   significant bits.
+*/
+#define TIMER_TIMEBASE_HZ      (F_CPU / TIMER_TIMEBASE_DIV)
+
+/* ticks <-> microseconds, folded at compile time for the common ratios */
+#if (TIMER_TIMEBASE_DIV * 1000000UL) % F_CPU == 0
+#define TIMER_TICKS_TO_US(t)   ((t) * (TIMER_TIMEBASE_DIV * 1000000UL / F_CPU))
+#elif F_CPU % (TIMER_TIMEBASE_DIV * 1000000UL) == 0
+#define TIMER_TICKS_TO_US(t)   ((t) / (F_CPU / (TIMER_TIMEBASE_DIV * 1000000UL)))
+#else
+#define TIMER_TICKS_TO_US(t)   ((uint64_t)(t) * TIMER_TIMEBASE_DIV * 1000000UL / F_CPU)
+#endif
+#define TIMER_US_TO_TICKS(us)  ((uint32_t)((uint64_t)(us) * TIMER_TIMEBASE_HZ / 1000000UL))
+
+void     TIMER_timebaseInit(void);
+uint32_t TIMER_nowTicks(void);
+uint64_t TIMER_nowTicks64(void);
+uint32_t TIMER_nowMicros(void);
+
+/* Elapsed time since a TIMER_nowTicks() stamp. The 16-bit form reads only
+   TCNT1 and is exact for intervals below 65536 clocks: profiling. */
+static inline uint32_t TIMER_elapsedTicks(uint32_t since) { return TIMER_nowTicks() - since; }
+static inline uint32_t TIMER_elapsedMicros(uint32_t since) { return (uint32_t)TIMER_TICKS_TO_US(TIMER_nowTicks() - since); }
+static inline uint16_t TIMER_elapsedTicks16(uint16_t since) { return (uint16_t)(TIMER_getCounter(TIMER_ID_1) - since); }
+
+#endif /* TIMER_INTERFACE_H_ */
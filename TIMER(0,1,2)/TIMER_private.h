@@ -0,0 +1,186 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< TIMER_private.h >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ * Author : Ahmed Shaban
+ * Layer  : MCAL
+ * SWC    : TIMER (Unified for Timer0, Timer1, Timer2)
+ */
+
+#ifndef TIMER_PRIVATE_H_
+#define TIMER_PRIVATE_H_
+
+/* ===================== Registers ============================ */
+/* TCCR0/TCNT0/OCR0, TCCR1A/B, TCNT1, OCR1A/B, ICR1, TCCR2/TCNT2/OCR2,
+   TIMSK/TIFR and the OC pin ports come from <avr/io.h>: the real avr-libc
+   header on target, SIM/include/avr/io.h in the host simulation build. */
+#include <avr/io.h>
+#include "TIMER_config.h"
+
+/* ===================== Bit Macros =========================== */
+/* Same values as <avr/io.h>; kept here as the driver's register map */
+/* Timer0 (TCCR0) */
+#define CS00   0
+#define CS01   1
+#define CS02   2
+#define WGM01  3
+#define COM00  4
+#define COM01  5
+#define WGM00  6
+#define FOC0   7
+
+/* Timer1 (TCCR1A) */
+#define WGM10  0
+#define WGM11  1
+#define FOC1B  2  // Force Output Compare B (non-PWM)
+#define FOC1A  3  // Force Output Compare A (non-PWM)
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+
+/* Timer1 (TCCR1B) */
+#define CS10   0
+#define CS11   1
+#define CS12   2
+#define WGM12  3
+#define WGM13  4
+#define ICES1  6
+#define ICNC1  7
+
+/* Timer2 (TCCR2) */
+#define CS20   0
+#define CS21   1
+#define CS22   2
+#define WGM21  3
+#define COM20  4
+#define COM21  5
+#define WGM20  6
+#define FOC2   7
+
+/* TIMSK (Interrupt Enable) */
+#define TOIE0   0
+#define OCIE0   1
+#define TOIE1   2
+#define OCIE1B  3
+#define OCIE1A  4
+#define TICIE1  5
+#define TOIE2   6
+#define OCIE2   7
+
+/* TIFR (Interrupt Flags) */
+#define TOV0    0
+#define OCF0    1
+#define TOV1    2
+#define OCF1B   3
+#define OCF1A   4
+#define ICF1    5
+#define TOV2    6
+#define OCF2    7
+
+/* OC pins */
+#define OC0_DDR  DDRB
+#define OC0_PIN  PB3
+
+#define OC1A_DDR DDRD
+#define OC1A_PIN PD5
+#define OC1B_DDR DDRD
+#define OC1B_PIN PD4
+
+#define OC2_DDR  DDRD
+#define OC2_PIN  PD7
+
+/* ICP1 input */
+#define ICP1_PINR PIND
+#define ICP1_PIN  PD6
+
+/* ===================== Shadow Registers ===================== */
+#define SHADOW_OCRA   0x01
+#define SHADOW_OCRB   0x02
+#define SHADOW_TOP    0x04
+
+typedef struct {
+    uint16_t ocr[2];     // OCRx / OCR1A, OCR1B
+    uint16_t top;        // ICR1
+    uint8_t  mask;       // SHADOW_* staged
+} timer_shadow_t;
+
+/* ===================== Dithered PWM ===================== */
+/* one first-order sigma-delta channel: OCR = base, plus one in the periods
+   where the 8-bit accumulator of frac carries */
+typedef struct {
+    uint16_t base;       // integer part of the OCR value
+    uint8_t  frac;       // fraction, 1/256 counts
+    uint8_t  acc;
+    uint8_t  on;
+} timer_dither_t;
+
+/* ===================== Vector Ownership ===================== */
+/* vectors TIMER_sw_program.c defines */
+#define SWT_OWNS_T0_COMP   (TIMER_SW_HW_TIMER == 0)
+#define SWT_OWNS_T0_OVF    (TIMER_SW_TICKLESS && TIMER_SW_HW_TIMER == 0)
+#define SWT_OWNS_T1_COMPA  (TIMER_SW_TICKLESS && TIMER_SW_HW_TIMER == 1)
+#define SWT_OWNS_T1_OVF    (TIMER_SW_TICKLESS && TIMER_SW_HW_TIMER == 1 && !TIMER_TIMEBASE_ENABLE)
+#define SWT_OWNS_T2_COMP   (TIMER_SW_HW_TIMER == 2)
+#define SWT_OWNS_T2_OVF    (TIMER_SW_TICKLESS && TIMER_SW_HW_TIMER == 2)
+
+/* vectors TIMER_spwm_program.c defines */
+#define SPWM_OWNS_T0_COMP  (TIMER_SPWM_HW_TIMER == 0)
+#define SPWM_OWNS_T2_COMP  (TIMER_SPWM_HW_TIMER == 2)
+
+/* TIMER_cap_program.c defines TIMER1_CAPT_vect when TIMER_CAP_ENABLE;
+   TIMER_program.c defines every other vector its services (time base,
+   shadow commit, dithering) or the application (TIMER_ISR_* not NONE)
+   need */
+#define PGM_OWNS_T0_OVF    (!SWT_OWNS_T0_OVF && ((TIMER_SHADOW_TIMERS & 0x01) || (TIMER_DITHER_TIMERS & 0x01) || \
+                                                 TIMER_ISR_T0_OVF))
+#define PGM_OWNS_T0_COMP   (!SWT_OWNS_T0_COMP && !SPWM_OWNS_T0_COMP && \
+                            ((TIMER_SHADOW_TIMERS & 0x01) || TIMER_ISR_T0_COMP))
+#define PGM_OWNS_T1_OVF    (!SWT_OWNS_T1_OVF && (TIMER_TIMEBASE_ENABLE || (TIMER_SHADOW_TIMERS & 0x02) || \
+                                                 (TIMER_DITHER_TIMERS & 0x02) || TIMER_ISR_T1_OVF))
+#define PGM_OWNS_T1_COMPA  (!SWT_OWNS_T1_COMPA && ((TIMER_SHADOW_TIMERS & 0x02) || TIMER_ISR_T1_COMPA))
+#define PGM_OWNS_T1_COMPB  (TIMER_ISR_T1_COMPB)
+#define PGM_OWNS_T1_CAPT   (!TIMER_CAP_ENABLE && TIMER_ISR_T1_CAPT)
+#define PGM_OWNS_T2_OVF    (!SWT_OWNS_T2_OVF && ((TIMER_SHADOW_TIMERS & 0x04) || (TIMER_DITHER_TIMERS & 0x04) || \
+                                                 TIMER_ISR_T2_OVF))
+#define PGM_OWNS_T2_COMP   (!SWT_OWNS_T2_COMP && !SPWM_OWNS_T2_COMP && \
+                            ((TIMER_SHADOW_TIMERS & 0x04) || TIMER_ISR_T2_COMP))
+
+/* ===================== Interrupt Dispatch ===================== */
+/* TIMER_DISPATCH_<vect>() ends every vector the driver defines, after its
+   service; indices are TIMER_Vector_t */
+#define TIMER_ISR_ANY(m)  (TIMER_ISR_T0_OVF == (m) || TIMER_ISR_T0_COMP == (m) || \
+                           TIMER_ISR_T1_OVF == (m) || TIMER_ISR_T1_COMPA == (m) || \
+                           TIMER_ISR_T1_COMPB == (m) || TIMER_ISR_T1_CAPT == (m) || \
+                           TIMER_ISR_T2_OVF == (m) || TIMER_ISR_T2_COMP == (m))
+
+#if TIMER_ISR_ANY(TIMER_ISR_RUNTIME)
+extern void (*timer_isr_cb[8])(void);    // TIMER_program.c
+#define TIMER_DISPATCH_RUNTIME(v)  do { void (*cb_)(void) = timer_isr_cb[v]; if (cb_) cb_(); } while (0)
+#endif
+#if TIMER_ISR_ANY(TIMER_ISR_STATIC)
+#include TIMER_ISR_HANDLERS_H
+#endif
+
+#define TIMER_DISPATCH_(mode, v, fn)  TIMER_DISPATCH_##mode(v, fn)
+#define TIMER_DISPATCH_0(v, fn)       ((void)0)
+#define TIMER_DISPATCH_1(v, fn)       TIMER_DISPATCH_RUNTIME(v)
+#define TIMER_DISPATCH_2(v, fn)       fn()
+#define TIMER_DISPATCH(mode, v, fn)   TIMER_DISPATCH_(mode, v, fn)
+
+#define TIMER_DISPATCH_T0_OVF()    TIMER_DISPATCH(TIMER_ISR_T0_OVF,   0, TIMER_ISR_HANDLER_T0_OVF)
+#define TIMER_DISPATCH_T0_COMP()   TIMER_DISPATCH(TIMER_ISR_T0_COMP,  1, TIMER_ISR_HANDLER_T0_COMP)
+#define TIMER_DISPATCH_T1_OVF()    TIMER_DISPATCH(TIMER_ISR_T1_OVF,   2, TIMER_ISR_HANDLER_T1_OVF)
+#define TIMER_DISPATCH_T1_COMPA()  TIMER_DISPATCH(TIMER_ISR_T1_COMPA, 3, TIMER_ISR_HANDLER_T1_COMPA)
+#define TIMER_DISPATCH_T1_COMPB()  TIMER_DISPATCH(TIMER_ISR_T1_COMPB, 4, TIMER_ISR_HANDLER_T1_COMPB)
+#define TIMER_DISPATCH_T1_CAPT()   TIMER_DISPATCH(TIMER_ISR_T1_CAPT,  5, TIMER_ISR_HANDLER_T1_CAPT)
+#define TIMER_DISPATCH_T2_OVF()    TIMER_DISPATCH(TIMER_ISR_T2_OVF,   6, TIMER_ISR_HANDLER_T2_OVF)
+#define TIMER_DISPATCH_T2_COMP()   TIMER_DISPATCH(TIMER_ISR_T2_COMP,  7, TIMER_ISR_HANDLER_T2_COMP)
+
+/* Shared between the TIMER sources: tickless software timers on Timer1
+   take the time base's overflow (TIMER_sw_program.c) */
+void timer_sw_overflow(void);
+
+/* Time base overflow count (TIMER_program.c). The capture ISR extends ICR1
+   with it instead of calling into the time base (TIMER_cap_program.c). */
+extern volatile uint32_t timer_tb_ovf;
+
+#endif /* TIMER_PRIVATE_H_ */
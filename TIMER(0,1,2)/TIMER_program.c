@@ -0,0 +1,866 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> TIMER_program.c <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Layer: MCAL
+// SWC  : TIMER (Unified)
+// Target: ATmega32
+
+#include "TIMER_interface.h"
+#include "TIMER_private.h"
+#include "TIMER_config.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#if TIMER_TIMEBASE_ENABLE
+#if TIMER_TIMEBASE_DIV != 1 && TIMER_TIMEBASE_DIV != 8 && TIMER_TIMEBASE_DIV != 64 && \
+    TIMER_TIMEBASE_DIV != 256 && TIMER_TIMEBASE_DIV != 1024
+#error "TIMER_TIMEBASE_DIV must be 1, 8, 64, 256 or 1024"
+#endif
+#define TB_CLK  (TIMER_TIMEBASE_DIV == 1 ? TIMER01_CLK_1 : TIMER_TIMEBASE_DIV == 8 ? TIMER01_CLK_8 : \
+                 TIMER_TIMEBASE_DIV == 64 ? TIMER01_CLK_64 : TIMER_TIMEBASE_DIV == 256 ? TIMER01_CLK_256 : \
+                 TIMER01_CLK_1024)
+
+volatile uint32_t timer_tb_ovf;    /* Timer1 overflows: bits 16..47 of the time */
+#endif
+
+#if TIMER_DITHER_TIMERS
+static timer_dither_t dt_ch[4];                /* OC0, OC1A, OC1B, OC2 */
+static uint8_t dt_irq_added;                  /* TOIEn the dithering turned on */
+#endif
+
+#if TIMER_SHADOW_TIMERS
+static timer_shadow_t sh_stage[3];            /* written by the application */
+static timer_shadow_t sh_pend[3];             /* committed, not yet in the registers */
+static uint16_t sh_top_next;                  /* Timer1 ICR1 due at the next interrupt */
+static volatile uint8_t sh_armed[3];
+static uint8_t sh_top_inflight;
+static uint8_t sh_on_comp[3];                 /* CTC: commit on the compare vector */
+static uint8_t sh_irq_added[3];               /* TIMSK bit the commit turned on */
+static volatile uint8_t sh_commits[3];
+static TIMER_CommitCallback_t sh_cb[3];
+#endif
+
+/* ===== Internal helpers: mode / OC mode bits per timer ===== */
+
+/* Control register bits are computed first and written with one store, so
+   no intermediate mode or output setting ever reaches the hardware */
+#define T0_WGM_MASK  ((1<<WGM01) | (1<<WGM00))
+#define T2_WGM_MASK  ((1<<WGM21) | (1<<WGM20))
+#define T1A_WGM_MASK ((1<<WGM11) | (1<<WGM10))
+#define T1B_WGM_MASK ((1<<WGM13) | (1<<WGM12))
+#define T1B_CS_MASK  ((1<<CS12) | (1<<CS11) | (1<<CS10))
+#define T1B_IC_MASK  ((1<<ICNC1) | (1<<ICES1))
+
+/* COMx1:COMx0 are adjacent: mode bit 1 -> COMx1, bit 0 -> COMx0 */
+#define OC_BITS(mode, com0)  ((uint8_t)(((uint8_t)(mode) & 0x03) << (com0)))
+
+static inline uint8_t _t0_wgm(TIMER_Mode_t mode) {
+    switch (mode) {
+        case TIMER_MODE_NORMAL: return 0;                              /* 00 */
+        case TIMER_MODE_CTC:    return (1<<WGM01);                     /* 10 */
+        case TIMER_MODE_FAST_PWM: return (1<<WGM00) | (1<<WGM01);      /* 11 */
+        case TIMER_MODE_PHASE_PWM: return (1<<WGM00);                  /* 01 */
+        /* no ICR: same slope, TOP = 0xFF */
+        case TIMER_MODE_FAST_PWM_ICR1: return (1<<WGM00) | (1<<WGM01);
+        case TIMER_MODE_PFC_PWM_ICR1:
+        case TIMER_MODE_PHASE_PWM_ICR1: return (1<<WGM00);
+    }
+    return 0;
+}
+
+static inline uint8_t _t2_wgm(TIMER_Mode_t mode) {
+    switch (mode) {
+        case TIMER_MODE_NORMAL: return 0;                              /* 00 */
+        case TIMER_MODE_CTC:    return (1<<WGM21);                     /* 10 */
+        case TIMER_MODE_FAST_PWM: return (1<<WGM20) | (1<<WGM21);      /* 11 */
+        case TIMER_MODE_PHASE_PWM: return (1<<WGM20);                  /* 01 */
+        case TIMER_MODE_FAST_PWM_ICR1: return (1<<WGM20) | (1<<WGM21);
+        case TIMER_MODE_PFC_PWM_ICR1:
+        case TIMER_MODE_PHASE_PWM_ICR1: return (1<<WGM20);
+    }
+    return 0;
+}
+
+/* For Timer1 we support: NORMAL, CTC (OCR1A top), FAST_PWM 8-bit, PHASE_PWM 8-bit
+   and the ICR1 TOP modes 8, 10, 14. TCCR1A bits in the low byte, TCCR1B
+   bits in the high byte. */
+#define T1_WGM(a, b)  ((uint16_t)(((uint16_t)(b) << 8) | (a)))
+static inline uint16_t _t1_wgm(TIMER_Mode_t mode) {
+    switch (mode) {
+        case TIMER_MODE_NORMAL: /* 0000 */ return 0;
+        case TIMER_MODE_CTC:    /* 0100 */ return T1_WGM(0, 1<<WGM12);        // OCR1A as TOP
+        case TIMER_MODE_FAST_PWM:          /* 0101: Fast PWM 8-bit */
+            return T1_WGM(1<<WGM10, 1<<WGM12);
+        case TIMER_MODE_PHASE_PWM:         /* 0001: Phase Correct PWM 8-bit */
+            return T1_WGM(1<<WGM10, 0);
+        case TIMER_MODE_PFC_PWM_ICR1:   /* 1000 */ return T1_WGM(0, 1<<WGM13);
+        case TIMER_MODE_PHASE_PWM_ICR1: /* 1010 */ return T1_WGM(1<<WGM11, 1<<WGM13);
+        case TIMER_MODE_FAST_PWM_ICR1:  /* 1110 */
+            return T1_WGM(1<<WGM11, (1<<WGM13) | (1<<WGM12));
+    }
+    return 0;
+}
+
+static inline void _t0_apply_mode(TIMER_Mode_t mode) {
+    TCCR0 = (uint8_t)((TCCR0 & ~T0_WGM_MASK) | _t0_wgm(mode));
+}
+
+static inline void _t2_apply_mode(TIMER_Mode_t mode) {
+    TCCR2 = (uint8_t)((TCCR2 & ~T2_WGM_MASK) | _t2_wgm(mode));
+}
+
+/* the two halves land in separate registers: callers stop the clock
+   around it when the timer may be running */
+static inline void _t1_apply_mode(TIMER_Mode_t mode) {
+    uint16_t w = _t1_wgm(mode);
+    TCCR1A = (uint8_t)((TCCR1A & ~T1A_WGM_MASK) | (uint8_t)w);
+    TCCR1B = (uint8_t)((TCCR1B & ~T1B_WGM_MASK) | (uint8_t)(w >> 8));
+}
+
+static inline void _t0_apply_ocA(TIMER_OCMode_t mode) {
+    TCCR0 = (uint8_t)((TCCR0 & ~((1<<COM01) | (1<<COM00))) | OC_BITS(mode, COM00));
+}
+
+static inline void _t2_apply_ocA(TIMER_OCMode_t mode) {
+    TCCR2 = (uint8_t)((TCCR2 & ~((1<<COM21) | (1<<COM20))) | OC_BITS(mode, COM20));
+}
+
+/* Timer1 has two channels */
+static inline void _t1_apply_ocA(TIMER_OCMode_t mode) {
+    TCCR1A = (uint8_t)((TCCR1A & ~((1<<COM1A1) | (1<<COM1A0))) | OC_BITS(mode, COM1A0));
+}
+static inline void _t1_apply_ocB(TIMER_OCMode_t mode) {
+    TCCR1A = (uint8_t)((TCCR1A & ~((1<<COM1B1) | (1<<COM1B0))) | OC_BITS(mode, COM1B0));
+}
+
+/* ===== API Implementation ===== */
+
+/* Each timer goes stop -> preload -> mode + clock: the control registers
+   are cleared (clock stopped, normal mode, outputs off), counter and
+   compare values are written, then mode, compare outputs and clock
+   select are stored together, then the OC pin direction, so the pin
+   comes up already driven by the compare unit, and the interrupt enables
+   last. */
+void TIMER_init(const TIMER_Config_t *cfg)
+{
+    uint8_t cs, on_a, on_b, b;
+    uint16_t w;
+
+    if (!cfg) return;
+    cs = cfg->clock_sel & 0x07;
+    on_a = cfg->configure_oc_pins && (cfg->oc_mode_A != TIMER_OC_DISCONNECTED);
+    on_b = cfg->configure_oc_pins && (cfg->oc_mode_B != TIMER_OC_DISCONNECTED);
+
+    /* Stopped, the timer cannot count (or match) between the preload and
+       the mode write; in normal mode OCR writes land directly, where a PWM
+       mode would only buffer them until TOP/BOTTOM. */
+    switch (cfg->id) {
+    case TIMER_ID_0:
+        TCCR0 = 0;
+        TCNT0 = (uint8_t)(cfg->tcnt_init & 0xFF);
+        OCR0  = (uint8_t)(cfg->ocrA_init & 0xFF);
+
+        /* mode | OC0 mode | clock */
+        TCCR0 = (uint8_t)(_t0_wgm(cfg->mode) | OC_BITS(cfg->oc_mode_A, COM00) | cs);
+
+        /* OC0 direction (optional) */
+        if (on_a) OC0_DDR |= (1<<OC0_PIN);
+
+        TIMER_enableInterrupts(TIMER_ID_0, cfg->int_ovf_enable, cfg->int_ocA_enable, 0);
+        break;
+
+    case TIMER_ID_1:
+        TCCR1B = (uint8_t)(TCCR1B & T1B_IC_MASK);
+        TCCR1A = 0;
+        _timer_write16(&TCNT1, cfg->tcnt_init);
+        _timer_write16(&OCR1A, cfg->ocrA_init);
+        _timer_write16(&OCR1B, cfg->ocrB_init);
+
+        /* mode | OC1A/OC1B modes, then mode | input capture bits | clock */
+        w = _t1_wgm(cfg->mode);
+        b = (uint8_t)((TCCR1B & T1B_IC_MASK) | (uint8_t)(w >> 8));
+        TCCR1A = (uint8_t)((uint8_t)w | OC_BITS(cfg->oc_mode_A, COM1A0) | OC_BITS(cfg->oc_mode_B, COM1B0));
+        /* TOP of the ICR1 modes: ICR1 is writable only once WGM13 is set,
+           so these modes take the mode bits before the clock. ICR1 only
+           captures in the others. */
+        if (cfg->mode >= TIMER_MODE_PFC_PWM_ICR1) {
+            TCCR1B = b;
+            _timer_write16(&ICR1, cfg->top_icr1);
+        }
+        TCCR1B = (uint8_t)(b | cs);
+
+        /* OC1A/OC1B directions (optional) */
+        if (on_a) OC1A_DDR |= (1<<OC1A_PIN);
+        if (on_b) OC1B_DDR |= (1<<OC1B_PIN);
+
+        TIMER_enableInterrupts(TIMER_ID_1, cfg->int_ovf_enable, cfg->int_ocA_enable, cfg->int_ocB_enable);
+        break;
+
+    case TIMER_ID_2:
+        TCCR2 = 0;
+        TCNT2 = (uint8_t)(cfg->tcnt_init & 0xFF);
+        OCR2  = (uint8_t)(cfg->ocrA_init & 0xFF);
+
+        TCCR2 = (uint8_t)(_t2_wgm(cfg->mode) | OC_BITS(cfg->oc_mode_A, COM20) | cs);
+
+        if (on_a) OC2_DDR |= (1<<OC2_PIN);
+
+        TIMER_enableInterrupts(TIMER_ID_2, cfg->int_ovf_enable, cfg->int_ocA_enable, 0);
+        break;
+    }
+}
+
+/* Out-of-line forms for a run-time id (TIMER_interface.h folds constant ids) */
+void (TIMER_start)(TIMER_ID_t id, uint8_t clock_sel)
+{
+    _timer_start(id, clock_sel);
+}
+
+void (TIMER_stop)(TIMER_ID_t id)
+{
+    _timer_stop(id);
+}
+
+void TIMER_setMode(TIMER_ID_t id, TIMER_Mode_t mode)
+{
+    /* Timer0/2: one masked write keeps the clock bits. Timer1's mode spans
+       both registers: the clock is stopped in the TCCR1B write and
+       restored after TCCR1A, so it never counts in a mixed mode. */
+    switch (id) {
+    case TIMER_ID_0:
+        _t0_apply_mode(mode);
+        break;
+    case TIMER_ID_1: {
+        uint8_t b = TCCR1B;
+        uint16_t w = _t1_wgm(mode);
+        TCCR1B = (uint8_t)((b & ~(T1B_WGM_MASK | T1B_CS_MASK)) | (uint8_t)(w >> 8));
+        TCCR1A = (uint8_t)((TCCR1A & ~T1A_WGM_MASK) | (uint8_t)w);
+        TCCR1B |= (uint8_t)(b & T1B_CS_MASK);
+    } break;
+    case TIMER_ID_2:
+        _t2_apply_mode(mode);
+        break;
+    }
+}
+
+void TIMER_setOCMode(TIMER_ID_t id, TIMER_Channel_t ch, TIMER_OCMode_t mode)
+{
+    switch (id) {
+    case TIMER_ID_0:
+        (void)ch; _t0_apply_ocA(mode); break;
+    case TIMER_ID_1:
+        if (ch == TIMER_CH_A) _t1_apply_ocA(mode);
+        else                  _t1_apply_ocB(mode);
+        break;
+    case TIMER_ID_2:
+        (void)ch; _t2_apply_ocA(mode); break;
+    }
+}
+
+void (TIMER_setCounter)(TIMER_ID_t id, uint16_t value)
+{
+    _timer_setCounter(id, value);
+}
+
+uint16_t (TIMER_getCounter)(TIMER_ID_t id)
+{
+    return _timer_getCounter(id);
+}
+
+void (TIMER_setCompare)(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t value)
+{
+    _timer_setCompare(id, ch, value);
+}
+
+void (TIMER_setDutyRaw)(TIMER_ID_t id, TIMER_Channel_t ch, uint8_t duty_0_255)
+{
+    _timer_setDutyRaw(id, ch, duty_0_255);
+}
+
+void TIMER_enableInterrupts(TIMER_ID_t id, uint8_t en_ovf, uint8_t en_ocA, uint8_t en_ocB)
+{
+    uint8_t m = 0, v = 0;
+
+    switch (id) {
+    case TIMER_ID_0:
+        m = (1<<TOIE0) | (1<<OCIE0);
+        if (en_ovf) v |= (1<<TOIE0);
+        if (en_ocA) v |= (1<<OCIE0);
+        break;
+    case TIMER_ID_1:
+        m = (1<<TOIE1) | (1<<OCIE1A) | (1<<OCIE1B);
+        if (en_ovf) v |= (1<<TOIE1);
+        if (en_ocA) v |= (1<<OCIE1A);
+        if (en_ocB) v |= (1<<OCIE1B);
+        break;
+    case TIMER_ID_2:
+        m = (1<<TOIE2) | (1<<OCIE2);
+        if (en_ovf) v |= (1<<TOIE2);
+        if (en_ocA) v |= (1<<OCIE2);
+        break;
+    }
+    TIMSK = (uint8_t)((TIMSK & ~m) | v);
+}
+
+/* ===== PWM Frequency Solver ===== */
+
+TIMER_PwmSetting_t TIMER_pwmSolve(TIMER_ID_t id, uint32_t hz, uint8_t dual)
+{
+    return _timer_pwm_solve(id, hz, dual);
+}
+
+uint8_t TIMER_pwmDualSlope(TIMER_ID_t id)
+{
+    switch (id) {
+    case TIMER_ID_0: return (TCCR0 & ((1<<WGM01)|(1<<WGM00))) == (1<<WGM00);
+    case TIMER_ID_1: return !(TCCR1B & (1<<WGM12)) && (TCCR1A & ((1<<WGM11)|(1<<WGM10)) ||
+                                                       (TCCR1B & (1<<WGM13)));
+    case TIMER_ID_2: return (TCCR2 & ((1<<WGM21)|(1<<WGM20))) == (1<<WGM20);
+    }
+    return 0;
+}
+
+TIMER_PwmSetting_t TIMER_pwmApply(TIMER_ID_t id, TIMER_PwmSetting_t s)
+{
+    if (!s.hz) return s;
+
+    switch (id) {
+    case TIMER_ID_0:
+        if (!(TCCR0 & (1<<WGM00))) _t0_apply_mode(TIMER_MODE_FAST_PWM);
+        break;
+    case TIMER_ID_2:
+        if (!(TCCR2 & (1<<WGM20))) _t2_apply_mode(TIMER_MODE_FAST_PWM);
+        break;
+    case TIMER_ID_1:
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            TIMER_stop(TIMER_ID_1);
+            if (!s.dual) _t1_apply_mode(TIMER_MODE_FAST_PWM_ICR1);
+            else if (!(TCCR1B & (1<<WGM13))) _t1_apply_mode(TIMER_MODE_PHASE_PWM_ICR1);
+            ICR1 = s.top;
+            /* past the new TOP the counter would run on to 0xFFFF */
+            if (TCNT1 >= s.top) TCNT1 = 0;
+        }
+        break;
+    }
+    TIMER_start(id, s.clock_sel);
+    return s;
+}
+
+#if TIMER_SHADOW_TIMERS || TIMER_DITHER_TIMERS
+/* compare registers double buffered by the hardware (any PWM mode) */
+static uint8_t _is_pwm(TIMER_ID_t id)
+{
+    switch (id) {
+    case TIMER_ID_0: return (TCCR0 & (1<<WGM00)) != 0;
+    case TIMER_ID_1: return ((TCCR1A & ((1<<WGM11)|(1<<WGM10))) != 0) ||
+                            ((TCCR1B & ((1<<WGM13)|(1<<WGM12))) == (1<<WGM13));
+    case TIMER_ID_2: return (TCCR2 & (1<<WGM20)) != 0;
+    }
+    return 0;
+}
+
+#endif
+
+/* ===== Shadow Registers ===== */
+#if TIMER_SHADOW_TIMERS
+
+/* CTC: TOP is the compare value and the overflow never comes */
+static uint8_t _is_ctc(TIMER_ID_t id)
+{
+    switch (id) {
+    case TIMER_ID_0: return (TCCR0 & ((1<<WGM01)|(1<<WGM00))) == (1<<WGM01);
+    case TIMER_ID_1: return (TCCR1B & ((1<<WGM13)|(1<<WGM12))) == (1<<WGM12) &&
+                            !(TCCR1A & ((1<<WGM11)|(1<<WGM10)));
+    case TIMER_ID_2: return (TCCR2 & ((1<<WGM21)|(1<<WGM20))) == (1<<WGM21);
+    }
+    return 0;
+}
+
+/* WGM 10: OCR1x load at TOP, TOV1 comes at BOTTOM */
+static uint8_t _t1_is_phase_icr(void)
+{
+    return (TCCR1B & ((1<<WGM13)|(1<<WGM12))) == (1<<WGM13) &&
+           (TCCR1A & ((1<<WGM11)|(1<<WGM10))) == (1<<WGM11);
+}
+
+static void _shadow_irq_bits(TIMER_ID_t id, uint8_t comp, uint8_t *ie, uint8_t *flag)
+{
+    static const uint8_t ovf_ie[3]  = { 1<<TOIE0, 1<<TOIE1, 1<<TOIE2 };
+    static const uint8_t ovf_f[3]   = { 1<<TOV0,  1<<TOV1,  1<<TOV2 };
+    static const uint8_t comp_ie[3] = { 1<<OCIE0, 1<<OCIE1A, 1<<OCIE2 };
+    static const uint8_t comp_f[3]  = { 1<<OCF0,  1<<OCF1A,  1<<OCF2 };
+    *ie   = comp ? comp_ie[id] : ovf_ie[id];
+    *flag = comp ? comp_f[id]  : ovf_f[id];
+}
+
+void TIMER_stageCompare(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t value)
+{
+    if (id > TIMER_ID_2 || !(TIMER_SHADOW_TIMERS & (1<<id))) return;
+    if (id != TIMER_ID_1) ch = TIMER_CH_A;
+    sh_stage[id].ocr[ch] = value;
+    sh_stage[id].mask |= (ch == TIMER_CH_A) ? SHADOW_OCRA : SHADOW_OCRB;
+}
+
+uint8_t TIMER_stageTop(TIMER_ID_t id, uint16_t top)
+{
+    if (id != TIMER_ID_1 || !(TIMER_SHADOW_TIMERS & (1<<TIMER_ID_1))) return 0;
+    /* no interrupt at the TOP where the new OCRs load: one half period
+       would run them against the old ICR1 */
+    if (_t1_is_phase_icr()) return 0;
+    sh_stage[id].top = top;
+    sh_stage[id].mask |= SHADOW_TOP;
+    return 1;
+}
+
+void TIMER_commit(TIMER_ID_t id)
+{
+    timer_shadow_t *s, *p;
+    uint8_t ie, flag;
+
+    if (id > TIMER_ID_2 || !(TIMER_SHADOW_TIMERS & (1<<id))) return;
+    s = &sh_stage[id];
+    p = &sh_pend[id];
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (s->mask & SHADOW_OCRA) p->ocr[0] = s->ocr[0];
+        if (s->mask & SHADOW_OCRB) p->ocr[1] = s->ocr[1];
+        if (s->mask & SHADOW_TOP)  p->top = s->top;
+        p->mask |= s->mask;
+        s->mask = 0;
+
+        if (!sh_armed[id]) {
+            sh_on_comp[id] = _is_ctc(id);
+            _shadow_irq_bits(id, sh_on_comp[id], &ie, &flag);
+            sh_irq_added[id] = 0;
+            if (!(TIMSK & ie)) {
+                /* a stale flag would commit mid-period */
+                TIFR = flag;
+                TIMSK |= ie;
+                sh_irq_added[id] = ie;
+            }
+            sh_armed[id] = 1;
+        }
+    }
+}
+
+uint8_t TIMER_commitPending(TIMER_ID_t id)
+{
+    return (id <= TIMER_ID_2) ? sh_armed[id] : 0;
+}
+
+uint8_t TIMER_commitCount(TIMER_ID_t id)
+{
+    return (id <= TIMER_ID_2) ? sh_commits[id] : 0;
+}
+
+void TIMER_setCommitCallback(TIMER_ID_t id, TIMER_CommitCallback_t cb)
+{
+    if (id <= TIMER_ID_2) sh_cb[id] = cb;
+}
+
+static void _shadow_done(TIMER_ID_t id)
+{
+    sh_commits[id]++;
+    if (sh_cb[id]) sh_cb[id](id);
+}
+
+/* Top of a period, interrupts off. Timer1 PWM with a new TOP takes two
+   interrupts: the OCRs go into the hardware buffer now and become active
+   at the next TOP; ICR1 is written right after that, as their period
+   starts. */
+static void _shadow_isr(TIMER_ID_t id, uint8_t comp)
+{
+    timer_shadow_t *p = &sh_pend[id];
+
+    if (!sh_armed[id] || sh_on_comp[id] != comp) return;
+
+    if (id == TIMER_ID_1 && sh_top_inflight) {
+        ICR1 = sh_top_next;
+        sh_top_inflight = 0;
+        _shadow_done(id);
+    }
+
+    if (p->mask) {
+        switch (id) {
+        case TIMER_ID_0: if (p->mask & SHADOW_OCRA) OCR0 = (uint8_t)p->ocr[0]; break;
+        case TIMER_ID_2: if (p->mask & SHADOW_OCRA) OCR2 = (uint8_t)p->ocr[0]; break;
+        case TIMER_ID_1:
+            if (p->mask & SHADOW_OCRA) OCR1A = p->ocr[0];
+            if (p->mask & SHADOW_OCRB) OCR1B = p->ocr[1];
+            if (p->mask & SHADOW_TOP) {
+                if (_is_pwm(id)) {
+                    sh_top_next = p->top;
+                    sh_top_inflight = 1;
+                } else {
+                    ICR1 = p->top;
+                }
+            }
+            break;
+        }
+        p->mask = 0;
+        if (!(id == TIMER_ID_1 && sh_top_inflight)) _shadow_done(id);
+    }
+
+    if (!(id == TIMER_ID_1 && sh_top_inflight)) {
+        TIMSK &= ~sh_irq_added[id];
+        sh_armed[id] = 0;
+    }
+}
+
+#if (TIMER_SHADOW_TIMERS & 0x01) && (SWT_OWNS_T0_COMP || SWT_OWNS_T0_OVF)
+#error "TIMER_SHADOW_TIMERS: Timer0 vectors are taken by the software timers"
+#endif
+#if (TIMER_SHADOW_TIMERS & 0x02) && (SWT_OWNS_T1_COMPA || SWT_OWNS_T1_OVF)
+#error "TIMER_SHADOW_TIMERS: Timer1 vectors are taken by the tickless software timers"
+#endif
+#if (TIMER_SHADOW_TIMERS & 0x04) && (SWT_OWNS_T2_COMP || SWT_OWNS_T2_OVF)
+#error "TIMER_SHADOW_TIMERS: Timer2 vectors are taken by the software timers"
+#endif
+
+#endif
+
+/* ===== Dithered PWM ===== */
+#if TIMER_DITHER_TIMERS
+
+#if (TIMER_DITHER_TIMERS & TIMER_SHADOW_TIMERS)
+#error "TIMER_DITHER_TIMERS: a timer is either shadowed or dithered (both write OCR at the overflow)"
+#endif
+#if (TIMER_DITHER_TIMERS & 0x02) && TIMER_TIMEBASE_ENABLE
+#error "TIMER_DITHER_TIMERS: Timer1 runs the time base in normal mode"
+#endif
+#if ((TIMER_DITHER_TIMERS & 0x01) && SWT_OWNS_T0_OVF) || ((TIMER_DITHER_TIMERS & 0x02) && SWT_OWNS_T1_OVF) || \
+    ((TIMER_DITHER_TIMERS & 0x04) && SWT_OWNS_T2_OVF)
+#error "TIMER_DITHER_TIMERS: the overflow vector is taken by the tickless software timers"
+#endif
+#if ((TIMER_DITHER_TIMERS & 0x01) && SPWM_OWNS_T0_COMP) || ((TIMER_DITHER_TIMERS & 0x04) && SPWM_OWNS_T2_COMP)
+#error "TIMER_DITHER_TIMERS: the software PWM rewrites that timer's OCR every edge"
+#endif
+
+/* the accumulator carried: a < frac */
+static inline uint16_t _dither_next(timer_dither_t *d)
+{
+    uint8_t a = (uint8_t)(d->acc + d->frac);
+    d->acc = a;
+    return (uint16_t)(d->base + (a < d->frac));
+}
+
+static const uint8_t dt_toie[3] = { 1<<TOIE0, 1<<TOIE1, 1<<TOIE2 };
+
+uint8_t TIMER_ditherSet(TIMER_ID_t id, TIMER_Channel_t ch, uint16_t duty)
+{
+    timer_dither_t *d;
+    uint16_t top = 0xFF;
+    uint32_t v;
+
+    if (id > TIMER_ID_2 || !(TIMER_DITHER_TIMERS & (1 << id))) return 0;
+    /* normal / CTC: the OCR is the software timers' or the application's */
+    if (!_is_pwm(id)) return 0;
+    d = &dt_ch[(id == TIMER_ID_0) ? 0 : (id == TIMER_ID_2) ? 3 : (ch == TIMER_CH_A) ? 1 : 2];
+    if (id == TIMER_ID_1 && (TCCR1B & (1<<WGM13))) top = _timer_read16(&ICR1);
+
+    /* OCR in 1/256 counts */
+    v = (uint32_t)duty * ((uint32_t)top + 1) >> 8;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        d->base = (uint16_t)(v >> 8);
+        d->frac = (uint8_t)v;
+        if (d->base >= top) {
+            d->base = top;
+            d->frac = 0;
+        }
+        d->on = 1;
+        if (!(TIMSK & dt_toie[id])) {
+            dt_irq_added |= dt_toie[id];
+            TIMSK |= dt_toie[id];
+        }
+    }
+    return 1;
+}
+
+void TIMER_ditherStop(TIMER_ID_t id, TIMER_Channel_t ch)
+{
+    timer_dither_t *d;
+
+    if (id > TIMER_ID_2 || !(TIMER_DITHER_TIMERS & (1 << id))) return;
+    d = &dt_ch[(id == TIMER_ID_0) ? 0 : (id == TIMER_ID_2) ? 3 : (ch == TIMER_CH_A) ? 1 : 2];
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        /* the last step may have left base + 1 */
+        if (d->on) {
+            switch (id) {
+            case TIMER_ID_0: OCR0 = (uint8_t)d->base; break;
+            case TIMER_ID_1: _timer_write16((ch == TIMER_CH_A) ? &OCR1A : &OCR1B, d->base); break;
+            case TIMER_ID_2: OCR2 = (uint8_t)d->base; break;
+            }
+        }
+        d->on = 0;
+        /* the last channel of the timer gives back the interrupt it took */
+        if (!(id == TIMER_ID_1 && (dt_ch[1].on || dt_ch[2].on))) {
+            TIMSK &= (uint8_t)~(dt_irq_added & dt_toie[id]);
+            dt_irq_added &= (uint8_t)~dt_toie[id];
+        }
+    }
+}
+
+#endif
+
+/* ===== Group Start ===== */
+
+#define T0_CS_MASK  ((1<<CS02) | (1<<CS01) | (1<<CS00))
+#define T2_CS_MASK  ((1<<CS22) | (1<<CS21) | (1<<CS20))
+
+/* counts a timer released at store k (0..2) gains on the last store */
+static uint16_t _group_lead(uint8_t clock_sel, uint8_t k)
+{
+    return ((clock_sel & 0x07) == 1) ? (uint16_t)((2u - k) * TIMER_GROUP_STORE_CYCLES) : 0;
+}
+
+void TIMER_startGroup(uint8_t mask, const TIMER_Group_t *g)
+{
+    uint8_t sreg = SREG;
+    uint8_t c0, c1, c2, sf;
+
+    if (!g || !(mask & TIMER_GROUP_ALL)) return;
+    cli();
+
+    /* stop and preload the selected timers; every release value is final
+       before the burst, which stores all three (unselected: unchanged) */
+    c0 = TCCR0;
+    c1 = TCCR1B;
+    c2 = TCCR2;
+    sf = SFIOR;
+    if (mask & TIMER_GROUP_T0) {
+        c0 &= (uint8_t)~T0_CS_MASK;
+        TCCR0 = c0;
+        TCNT0 = (uint8_t)(g->tcnt[0] - _group_lead(g->clock_sel[0], 0));
+        c0 |= (uint8_t)(g->clock_sel[0] & 0x07);
+        sf |= (1<<PSR10);
+    }
+    if (mask & TIMER_GROUP_T1) {
+        c1 &= (uint8_t)~T1B_CS_MASK;
+        TCCR1B = c1;
+        TCNT1 = (uint16_t)(g->tcnt[1] - _group_lead(g->clock_sel[1], 1));
+        c1 |= (uint8_t)(g->clock_sel[1] & 0x07);
+        sf |= (1<<PSR10);
+    }
+    if (mask & TIMER_GROUP_T2) {
+        c2 &= (uint8_t)~T2_CS_MASK;
+        TCCR2 = c2;
+        TCNT2 = (uint8_t)(g->tcnt[2] - _group_lead(g->clock_sel[2], 2));
+        c2 |= (uint8_t)(g->clock_sel[2] & 0x07);
+        sf |= (1<<PSR2);
+    }
+
+    SFIOR = sf;
+    TCCR0 = c0;
+    TCCR1B = c1;
+    TCCR2 = c2;
+    SREG = sreg;
+}
+
+uint8_t TIMER_groupSkewTest(int8_t skew[3])
+{
+    static const TIMER_Group_t clk1 = { { 1, 1, 1 }, { 0, 0, 0 } };
+    uint8_t sreg = SREG;
+    uint8_t mask = TIMER_GROUP_ALL;
+    uint8_t flags = (1<<TOV0) | (1<<OCF0) | (1<<TOV2) | (1<<OCF2);
+    uint8_t t0, t1a, t1b, t2;
+    uint8_t r0, r1, r2, q0, q1, q2;
+
+    cli();
+#if TIMER_TIMEBASE_ENABLE
+    /* a running time base is not stopped or zeroed: TIMER_nowTicks() would
+       step back */
+    if ((TIMSK & (1<<TOIE1)) && (TCCR1B & T1B_CS_MASK)) mask = TIMER_GROUP_T0 | TIMER_GROUP_T2;
+#endif
+    t0 = TCCR0;
+    t1a = TCCR1A;
+    t1b = TCCR1B;
+    t2 = TCCR2;
+    /* normal mode, outputs off: nothing wraps or toggles in the test */
+    TCCR0 = 0;
+    TCCR2 = 0;
+    if (mask & TIMER_GROUP_T1) {
+        TCCR1A = 0;
+        TCCR1B = (uint8_t)(t1b & T1B_IC_MASK);
+    }
+
+    TIMER_startGroup(mask, &clk1);
+    /* TCNT1L read either way, so the read spacing stays symmetric */
+    r0 = TCNT0;
+    r1 = TCNT1L;
+    r2 = TCNT2;
+    q2 = TCNT2;
+    q1 = TCNT1L;
+    q0 = TCNT0;
+
+    TCCR0 = (uint8_t)(t0 & ~T0_CS_MASK);
+    TCCR2 = (uint8_t)(t2 & ~T2_CS_MASK);
+    TCNT0 = 0;
+    TCNT2 = 0;
+    if (mask & TIMER_GROUP_T1) {
+        TCCR1B = (uint8_t)(t1b & ~T1B_CS_MASK);
+        TCCR1A = t1a;
+        TCNT1 = 0;
+        flags |= (1<<TOV1) | (1<<OCF1A) | (1<<OCF1B);
+    }
+    TIFR = flags;
+    SREG = sreg;
+
+    /* forward and reverse read spacings are opposite: the sum is 2 x skew */
+    skew[0] = 0;
+    skew[1] = (mask & TIMER_GROUP_T1)
+            ? (int8_t)(((int8_t)(uint8_t)(r1 - r0) + (int8_t)(uint8_t)(q1 - q0)) / 2) : 0;
+    skew[2] = (int8_t)(((int8_t)(uint8_t)(r2 - r0) + (int8_t)(uint8_t)(q2 - q0)) / 2);
+    return mask;
+}
+
+/* ===== Time Base (Timer1) ===== */
+#if TIMER_TIMEBASE_ENABLE
+
+/* Keeps counting from wherever TCNT1 / the overflow count are, so calling
+   it again never steps the time back */
+void TIMER_timebaseInit(void)
+{
+    uint8_t sreg = SREG;
+    cli();
+    TCCR1A = 0;                       // normal mode, OC1A/OC1B disconnected
+    TCCR1B = (uint8_t)((TCCR1B & T1B_IC_MASK) | TB_CLK);
+    TIMSK |= (1<<TOIE1);
+    SREG = sreg;
+}
+
+/* interrupts off. TOV1 still set after TCNT1 was read with a small value:
+   the counter wrapped and the ISR has not counted it yet. A large value
+   was read before the wrap. */
+static inline uint32_t _tb_ovf_now(uint16_t *cnt)
+{
+    uint32_t ovf = timer_tb_ovf;
+    uint16_t c = TCNT1;
+    if ((TIFR & (1<<TOV1)) && c < 0x8000) ovf++;
+    *cnt = c;
+    return ovf;
+}
+
+uint32_t TIMER_nowTicks(void)
+{
+    uint32_t ovf;
+    uint16_t c;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ovf = _tb_ovf_now(&c); }
+    return ((uint32_t)(uint16_t)ovf << 16) | c;
+}
+
+uint64_t TIMER_nowTicks64(void)
+{
+    uint32_t ovf;
+    uint16_t c;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { ovf = _tb_ovf_now(&c); }
+    return ((uint64_t)ovf << 16) | c;
+}
+
+/* from the 64-bit count so the result wraps at 2^32 us like a counter */
+uint32_t TIMER_nowMicros(void)
+{
+    return (uint32_t)TIMER_TICKS_TO_US(TIMER_nowTicks64());
+}
+
+#endif
+
+/* ===== Interrupt Dispatch ===== */
+/* Each vector: the driver service first, then the application handler */
+
+#if TIMER_ISR_ANY(TIMER_ISR_RUNTIME)
+void (*timer_isr_cb[8])(void);
+
+void TIMER_setCallback(TIMER_Vector_t v, TIMER_Callback_t cb)
+{
+    if (v >= TIMER_VECT_COUNT) return;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { timer_isr_cb[v] = cb; }
+}
+#endif
+
+#if PGM_OWNS_T0_OVF
+ISR(TIMER0_OVF_vect)
+{
+#if (TIMER_SHADOW_TIMERS & 0x01)
+    _shadow_isr(TIMER_ID_0, 0);
+#endif
+#if (TIMER_DITHER_TIMERS & 0x01)
+    if (dt_ch[0].on) OCR0 = (uint8_t)_dither_next(&dt_ch[0]);
+#endif
+    TIMER_DISPATCH_T0_OVF();
+}
+#endif
+
+#if PGM_OWNS_T0_COMP
+ISR(TIMER0_COMP_vect)
+{
+#if (TIMER_SHADOW_TIMERS & 0x01)
+    _shadow_isr(TIMER_ID_0, 1);
+#endif
+    TIMER_DISPATCH_T0_COMP();
+}
+#endif
+
+#if PGM_OWNS_T1_OVF
+ISR(TIMER1_OVF_vect)
+{
+#if TIMER_TIMEBASE_ENABLE
+    timer_tb_ovf++;
+#if TIMER_SW_TICKLESS && TIMER_SW_HW_TIMER == 1
+    timer_sw_overflow();
+#endif
+#endif
+#if (TIMER_SHADOW_TIMERS & 0x02)
+    _shadow_isr(TIMER_ID_1, 0);
+#endif
+#if (TIMER_DITHER_TIMERS & 0x02)
+    if (dt_ch[1].on) OCR1A = _dither_next(&dt_ch[1]);
+    if (dt_ch[2].on) OCR1B = _dither_next(&dt_ch[2]);
+#endif
+    TIMER_DISPATCH_T1_OVF();
+}
+#endif
+
+#if PGM_OWNS_T1_COMPA
+ISR(TIMER1_COMPA_vect)
+{
+#if (TIMER_SHADOW_TIMERS & 0x02)
+    _shadow_isr(TIMER_ID_1, 1);
+#endif
+    TIMER_DISPATCH_T1_COMPA();
+}
+#endif
+
+#if PGM_OWNS_T1_COMPB
+ISR(TIMER1_COMPB_vect)
+{
+    TIMER_DISPATCH_T1_COMPB();
+}
+#endif
+
+#if PGM_OWNS_T1_CAPT
+ISR(TIMER1_CAPT_vect)
+{
+    TIMER_DISPATCH_T1_CAPT();
+}
+#endif
+
+#if PGM_OWNS_T2_OVF
+ISR(TIMER2_OVF_vect)
+{
+#if (TIMER_SHADOW_TIMERS & 0x04)
+    _shadow_isr(TIMER_ID_2, 0);
+#endif
+#if (TIMER_DITHER_TIMERS & 0x04)
+    if (dt_ch[3].on) OCR2 = (uint8_t)_dither_next(&dt_ch[3]);
+#endif
+    TIMER_DISPATCH_T2_OVF();
+}
+#endif
+
+#if PGM_OWNS_T2_COMP
+ISR(TIMER2_COMP_vect)
+{
+#if (TIMER_SHADOW_TIMERS & 0x04)
+    _shadow_isr(TIMER_ID_2, 1);
+#endif
+    TIMER_DISPATCH_T2_COMP();
+}
+#endif
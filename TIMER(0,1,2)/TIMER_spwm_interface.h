@@ -0,0 +1,67 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    TIMER_spwm_interface.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL
+ *  SWC    : TIMER (software PWM)
+ *
+ *  Up to TIMER_SPWM_CHANNELS PWM outputs on any port pins, 8-bit duty, on
+ *  one free-running timer (TIMER_SPWM_HW_TIMER, TIMER_config.h).
+ *
+ *  The channels are kept as an edge schedule: one slot per distinct duty,
+ *  sorted, each holding the AND masks that take its pins low on every
+ *  port. At count 0 the compare interrupt drives the pins of all channels
+ *  with duty > 0 high in one write per port, then it is reprogrammed for
+ *  each slot in turn and only applies that slot's masks. Slots due within
+ *  the next count are applied in the same interrupt, so edges closer
+ *  together than the ISR are never missed, only late.
+ *
+ *  TIMER_spwmSetDuty edits a standby copy of the schedule: the channel
+ *  leaves one slot and joins another (O(slots), no re-sort), and the
+ *  copy becomes active at the next period start, so a period never mixes
+ *  old and new edges. Changes made within one period are applied together.
+ *
+ *  ISR cost per interrupt: a fixed part, plus per slot applied one
+ *  read-modify-write per port in TIMER_SPWM_PORTS. The worst case is
+ *  every duty distinct and adjacent, all slots in one interrupt: BENCH
+ *  reports isr.TIMER0_COMP_vect_spwm<n> for 1, 8, 16 and 24 channels.
+ *  Measured on the SIM model (BENCH/bench_baseline_sim.txt):
+ *      channels        1     8     16    24
+ *      ISR cycles      17    66    122   178
+ *  about 7 per added channel. The model counts interrupt entry/exit and
+ *  register accesses, not instructions; the avr-gcc figures are higher
+ *  and are recorded by `make -C BENCH bench-baseline` on that toolchain.
+ *  TIMER_spwmPeakLate() gives the worst lateness of an edge seen at run time.
+ *
+ *  The ISR rewrites whole PORTx registers: other code must change pins on
+ *  those ports with single-bit sbi/cbi or inside ATOMIC_BLOCK.
+ */
+
+#ifndef TIMER_SPWM_INTERFACE_H_
+#define TIMER_SPWM_INTERFACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TIMER_config.h"
+
+typedef enum {
+    TIMER_SPWM_PORT_A = 0,
+    TIMER_SPWM_PORT_B,
+    TIMER_SPWM_PORT_C,
+    TIMER_SPWM_PORT_D
+} TIMER_SpwmPort_t;
+
+#define TIMER_SPWM_NONE   0xFF      // TIMER_spwmAddChannel: table full / bad pin
+
+/* PWM frequency */
+#define TIMER_SPWM_HZ     (F_CPU / (TIMER_SPWM_DIV * 256UL))
+
+/* ===================== API ===================== */
+void    TIMER_spwmInit(void);                     // before adding channels
+void    TIMER_spwmStop(void);                     // all channel pins low
+uint8_t TIMER_spwmAddChannel(TIMER_SpwmPort_t port, uint8_t pin);  // pin -> output, duty 0
+void    TIMER_spwmSetDuty(uint8_t ch, uint8_t duty);   // 0 off, 255 on, else duty/256
+uint8_t TIMER_spwmGetDuty(uint8_t ch);
+bool    TIMER_spwmPending(void);                  // changes not yet in the running period
+uint8_t TIMER_spwmPeakLate(void);                 // worst edge lateness, timer counts
+
+#endif /* TIMER_SPWM_INTERFACE_H_ */
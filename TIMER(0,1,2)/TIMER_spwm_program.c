@@ -0,0 +1,323 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> TIMER_spwm_program.c <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Layer: MCAL
+// SWC  : TIMER (software PWM)
+// Target: ATmega32
+
+#include "TIMER_spwm_interface.h"
+#include "TIMER_interface.h"
+#include "TIMER_config.h"
+#include "TIMER_private.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#if TIMER_SPWM_HW_TIMER != 255
+
+#if TIMER_SPWM_CHANNELS < 1 || TIMER_SPWM_CHANNELS > 32
+#error "TIMER_SPWM_CHANNELS must be 1..32"
+#endif
+#if !(TIMER_SPWM_PORTS & 0x0F)
+#error "TIMER_SPWM_PORTS: no port selected"
+#endif
+
+#if TIMER_SPWM_HW_TIMER == 0
+#if SWT_OWNS_T0_COMP || (TIMER_SHADOW_TIMERS & 0x01)
+#error "TIMER_SPWM_HW_TIMER 0: Timer0 is taken by the software timers / shadow registers"
+#endif
+#if TIMER_SPWM_DIV != 1 && TIMER_SPWM_DIV != 8 && TIMER_SPWM_DIV != 64 && \
+    TIMER_SPWM_DIV != 256 && TIMER_SPWM_DIV != 1024
+#error "TIMER_SPWM_DIV must be 1, 8, 64, 256 or 1024 on Timer0"
+#endif
+#define SP_ID        TIMER_ID_0
+#define SP_CLK       (TIMER_SPWM_DIV == 1 ? TIMER01_CLK_1 : TIMER_SPWM_DIV == 8 ? TIMER01_CLK_8 : \
+                      TIMER_SPWM_DIV == 64 ? TIMER01_CLK_64 : TIMER_SPWM_DIV == 256 ? TIMER01_CLK_256 : \
+                      TIMER01_CLK_1024)
+#define SP_TCNT      TCNT0
+#define SP_OCR       OCR0
+#define SP_OCIE      OCIE0
+#define SP_OCF       OCF0
+#define SP_COMP_vect TIMER0_COMP_vect
+#define SP_DISPATCH() TIMER_DISPATCH_T0_COMP()
+#elif TIMER_SPWM_HW_TIMER == 2
+#if SWT_OWNS_T2_COMP || (TIMER_SHADOW_TIMERS & 0x04)
+#error "TIMER_SPWM_HW_TIMER 2: Timer2 is taken by the software timers / shadow registers"
+#endif
+#if TIMER_SPWM_DIV != 1 && TIMER_SPWM_DIV != 8 && TIMER_SPWM_DIV != 32 && TIMER_SPWM_DIV != 64 && \
+    TIMER_SPWM_DIV != 128 && TIMER_SPWM_DIV != 256 && TIMER_SPWM_DIV != 1024
+#error "TIMER_SPWM_DIV must be 1, 8, 32, 64, 128, 256 or 1024 on Timer2"
+#endif
+#define SP_ID        TIMER_ID_2
+#define SP_CLK       (TIMER_SPWM_DIV == 1 ? TIMER2_CLK_1 : TIMER_SPWM_DIV == 8 ? TIMER2_CLK_8 : \
+                      TIMER_SPWM_DIV == 32 ? TIMER2_CLK_32 : TIMER_SPWM_DIV == 64 ? TIMER2_CLK_64 : \
+                      TIMER_SPWM_DIV == 128 ? TIMER2_CLK_128 : TIMER_SPWM_DIV == 256 ? TIMER2_CLK_256 : \
+                      TIMER2_CLK_1024)
+#define SP_TCNT      TCNT2
+#define SP_OCR       OCR2
+#define SP_OCIE      OCIE2
+#define SP_OCF       OCF2
+#define SP_COMP_vect TIMER2_COMP_vect
+#define SP_DISPATCH() TIMER_DISPATCH_T2_COMP()
+#else
+#error "TIMER_SPWM_HW_TIMER must be 0, 2 or 255"
+#endif
+
+/* one slot per distinct duty; slot 0 is the period start at count 0, its
+   keep masks drop every channel pin before the set masks raise the ones
+   with duty > 0 */
+typedef struct {
+    uint8_t at;                // compare count
+    uint8_t keep[4];           // PORTA..PORTD &= keep
+} spwm_slot_t;
+
+typedef struct {
+    uint8_t n;                 // slots 1..n, at ascending
+    uint8_t set[4];            // PORTA..PORTD |= set at count 0
+    spwm_slot_t slot[TIMER_SPWM_CHANNELS + 1];
+} spwm_sched_t;
+
+typedef struct {
+    uint8_t port;
+    uint8_t mask;
+    uint8_t duty;
+} spwm_chan_t;
+
+static spwm_sched_t sp_buf[2];
+static const spwm_sched_t *sp_run;        /* ISR: schedule of the running period */
+static volatile uint8_t sp_act;           /* index of the active schedule */
+static volatile uint8_t sp_swap;          /* standby ready: take it at count 0 */
+static volatile uint8_t sp_fresh;         /* standby already holds the active one */
+static uint8_t sp_i;                      /* ISR: slot the compare is set for */
+static volatile uint8_t sp_on;
+static volatile uint8_t sp_peak;
+static spwm_chan_t sp_ch[TIMER_SPWM_CHANNELS];
+static uint8_t sp_nch;
+
+static volatile uint8_t *_sp_port(uint8_t port)
+{
+    switch (port) {
+    case TIMER_SPWM_PORT_A: return &PORTA;
+    case TIMER_SPWM_PORT_B: return &PORTB;
+    case TIMER_SPWM_PORT_C: return &PORTC;
+    default:                return &PORTD;
+    }
+}
+
+static volatile uint8_t *_sp_ddr(uint8_t port)
+{
+    switch (port) {
+    case TIMER_SPWM_PORT_A: return &DDRA;
+    case TIMER_SPWM_PORT_B: return &DDRB;
+    case TIMER_SPWM_PORT_C: return &DDRC;
+    default:                return &DDRD;
+    }
+}
+
+/* ===== Schedule edits (standby copy) ===== */
+
+/* The ISR does not swap while sp_swap is 0, so the standby is ours */
+static spwm_sched_t *_sp_begin(void)
+{
+    spwm_sched_t *s;
+
+    sp_swap = 0;
+    s = &sp_buf[sp_act ^ 1];
+    if (!sp_fresh) {
+        *s = sp_buf[sp_act];
+        sp_fresh = 1;
+    }
+    return s;
+}
+
+static void _sp_unlink(spwm_sched_t *s, const spwm_chan_t *c)
+{
+    uint8_t j, k;
+
+    if (c->duty == 0) return;
+    s->set[c->port] &= (uint8_t)~c->mask;
+    if (c->duty == 255) return;
+    for (j = 1; j <= s->n && s->slot[j].at != c->duty; j++) { }
+    if (j > s->n) return;
+    s->slot[j].keep[c->port] |= c->mask;
+    for (k = 0; k < 4; k++)
+        if (s->slot[j].keep[k] != 0xFF) return;
+    /* last pin of the slot: close the gap */
+    s->n--;
+    for (; j <= s->n; j++) s->slot[j] = s->slot[j + 1];
+}
+
+static void _sp_link(spwm_sched_t *s, const spwm_chan_t *c)
+{
+    uint8_t j, k;
+
+    if (c->duty == 0) return;
+    s->set[c->port] |= c->mask;
+    if (c->duty == 255) return;
+    for (j = 1; j <= s->n && s->slot[j].at < c->duty; j++) { }
+    if (j > s->n || s->slot[j].at != c->duty) {
+        for (k = s->n; k >= j; k--) s->slot[k + 1] = s->slot[k];
+        s->n++;
+        s->slot[j].at = c->duty;
+        for (k = 0; k < 4; k++) s->slot[j].keep[k] = 0xFF;
+    }
+    s->slot[j].keep[c->port] &= (uint8_t)~c->mask;
+}
+
+/* ===== API Implementation ===== */
+
+void TIMER_spwmInit(void)
+{
+    const TIMER_Config_t cfg = {
+        .id = SP_ID,
+        .mode = TIMER_MODE_NORMAL,
+        .clock_sel = SP_CLK
+    };
+    uint8_t b, k;
+
+    TIMSK &= (uint8_t)~(1<<SP_OCIE);
+    sp_on = 0;
+    for (b = 0; b < 2; b++) {
+        sp_buf[b].n = 0;
+        for (k = 0; k < 4; k++) {
+            sp_buf[b].set[k] = 0;
+            sp_buf[b].slot[0].keep[k] = 0xFF;
+        }
+        sp_buf[b].slot[0].at = 0;
+    }
+    sp_act = 0;
+    sp_swap = 0;
+    sp_fresh = 1;
+    sp_run = &sp_buf[0];
+    sp_i = 0;
+    sp_peak = 0;
+    sp_nch = 0;
+
+    TIMER_init(&cfg);                 // OCR = 0: the first interrupt starts a period
+    sp_on = 1;
+    TIFR = (1<<SP_OCF);
+    TIMSK |= (1<<SP_OCIE);
+}
+
+void TIMER_spwmStop(void)
+{
+    uint8_t c;
+
+    TIMSK &= (uint8_t)~(1<<SP_OCIE);
+    sp_on = 0;
+    TIMER_stop(SP_ID);
+    for (c = 0; c < sp_nch; c++) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *_sp_port(sp_ch[c].port) &= (uint8_t)~sp_ch[c].mask; }
+    }
+}
+
+uint8_t TIMER_spwmAddChannel(TIMER_SpwmPort_t port, uint8_t pin)
+{
+    spwm_sched_t *s;
+    spwm_chan_t *c;
+
+    if (sp_nch >= TIMER_SPWM_CHANNELS || port > TIMER_SPWM_PORT_D || pin > 7 ||
+        !(TIMER_SPWM_PORTS & (1 << port))) return TIMER_SPWM_NONE;
+
+    c = &sp_ch[sp_nch];
+    c->port = (uint8_t)port;
+    c->mask = (uint8_t)(1 << pin);
+    c->duty = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        *_sp_port(port) &= (uint8_t)~c->mask;
+        *_sp_ddr(port) |= c->mask;
+    }
+    s = _sp_begin();
+    s->slot[0].keep[port] &= (uint8_t)~c->mask;
+    sp_swap = 1;
+    return sp_nch++;
+}
+
+void TIMER_spwmSetDuty(uint8_t ch, uint8_t duty)
+{
+    spwm_sched_t *s;
+    spwm_chan_t *c;
+
+    if (ch >= sp_nch || sp_ch[ch].duty == duty) return;
+    c = &sp_ch[ch];
+    s = _sp_begin();
+    _sp_unlink(s, c);
+    c->duty = duty;
+    _sp_link(s, c);
+    sp_swap = 1;
+}
+
+uint8_t TIMER_spwmGetDuty(uint8_t ch)
+{
+    return (ch < sp_nch) ? sp_ch[ch].duty : 0;
+}
+
+bool TIMER_spwmPending(void)
+{
+    return sp_swap != 0;
+}
+
+uint8_t TIMER_spwmPeakLate(void)
+{
+    return sp_peak;
+}
+
+/* ===== ISR ===== */
+
+#define SP_PORT_WRITE(k, reg, op)   if (TIMER_SPWM_PORTS & (1 << (k))) { reg op; }
+#define SP_APPLY(sl)  do { \
+        SP_PORT_WRITE(0, PORTA, &= (sl)->keep[0]) \
+        SP_PORT_WRITE(1, PORTB, &= (sl)->keep[1]) \
+        SP_PORT_WRITE(2, PORTC, &= (sl)->keep[2]) \
+        SP_PORT_WRITE(3, PORTD, &= (sl)->keep[3]) \
+    } while (0)
+#define SP_START(s)   do { \
+        SP_PORT_WRITE(0, PORTA, = (uint8_t)((PORTA & (s)->slot[0].keep[0]) | (s)->set[0])) \
+        SP_PORT_WRITE(1, PORTB, = (uint8_t)((PORTB & (s)->slot[0].keep[1]) | (s)->set[1])) \
+        SP_PORT_WRITE(2, PORTC, = (uint8_t)((PORTC & (s)->slot[0].keep[2]) | (s)->set[2])) \
+        SP_PORT_WRITE(3, PORTD, = (uint8_t)((PORTD & (s)->slot[0].keep[3]) | (s)->set[3])) \
+    } while (0)
+
+/* Count 0 starts a period (and takes a ready standby schedule); any other
+   compare is slot sp_i. OCFn is set as the counter leaves OCRn, so every
+   edge, the period start included, lands one count after its value. The
+   next slot's compare is written first and the counter checked after: a
+   slot the counter has already passed would not fire until the next
+   period, so it is applied here (its flag, if the match came after the
+   write, is cleared) and the one after it is tried. */
+ISR(SP_COMP_vect)
+{
+    const spwm_sched_t *s;
+    uint8_t i, due, late;
+
+    if (sp_on) {
+        i = sp_i;
+        if (i == 0) {
+            if (sp_swap) {
+                sp_act ^= 1;
+                sp_swap = 0;
+                sp_fresh = 0;
+            }
+            sp_run = s = &sp_buf[sp_act];
+            SP_START(s);
+        } else {
+            s = sp_run;
+            SP_APPLY(&s->slot[i]);
+        }
+        due = s->slot[i].at;
+        while (++i <= s->n) {
+            SP_OCR = s->slot[i].at;
+            if (SP_TCNT <= s->slot[i].at) break;
+            SP_APPLY(&s->slot[i]);              // reached meanwhile: late
+            TIFR = (1 << SP_OCF);
+        }
+        if (i > s->n) {
+            i = 0;
+            SP_OCR = 0;
+        }
+        sp_i = i;
+
+        late = (uint8_t)(SP_TCNT - due - 1u);
+        if (late > sp_peak) sp_peak = late;
+    }
+    SP_DISPATCH();
+}
+
+#endif
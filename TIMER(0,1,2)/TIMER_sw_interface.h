@@ -0,0 +1,65 @@
+/*
+ *<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<    TIMER_sw_interface.h    >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+ *
+ *  Layer  : MCAL
+ *  SWC    : TIMER (software timers)
+ *
+ *  Any number of one-shot and periodic timers on one hardware compare
+ *  interrupt (TIMER_SW_HW_TIMER, TIMER_config.h). The timers live in a
+ *  hierarchical timing wheel: TIMER_SW_LEVELS levels of 2^TIMER_SW_WHEEL_BITS
+ *  slots, each level covering WHEEL_BITS more bits of the expiry tick.
+ *
+ *  Cost, independent of how many timers exist:
+ *    TIMER_swStart / TIMER_swStop   O(1): unlink + link into one slot
+ *    tick                           O(1) + the timers that expire on it
+ *                                   + the timers moved down from one upper
+ *                                   slot when a lower level wraps
+ *  A timer moves down at most TIMER_SW_LEVELS - 1 times in its life, so the
+ *  moves are a bounded per-timer cost, not a per-tick one; TIMER_swPeakWork()
+ *  reports the worst tick seen.
+ *
+ *  Tickless mode (TIMER_SW_TICKLESS): a tick is one count of a free-running
+ *  timer and the compare interrupt is programmed for the next tick with work
+ *  only, so an idle wheel costs one overflow interrupt per counter period.
+ *  Start stays O(1); finding the next event looks at most 2^bits slots per
+ *  level and runs once per event.
+ *
+ *  Callbacks run in the tick ISR with interrupts off: keep them short.
+ *  They may start or stop any timer, including their own.
+ */
+
+#ifndef TIMER_SW_INTERFACE_H_
+#define TIMER_SW_INTERFACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TIMER_config.h"
+
+/* milliseconds -> ticks, rounded up (constant folded for constant ms) */
+#define TIMER_SW_MS(ms)  ((TIMER_SWTick_t)(((uint32_t)(ms) * TIMER_SW_TICK_HZ + 999UL) / 1000UL))
+
+typedef uint32_t TIMER_SWTick_t;
+typedef void (*TIMER_SWCallback_t)(void *arg);
+
+/* Caller owned; the link fields belong to the driver while the timer runs */
+typedef struct TIMER_SW_s {
+    struct TIMER_SW_s  *next;
+    struct TIMER_SW_s **pprev;     // NULL while stopped
+    TIMER_SWTick_t      expires;   // absolute tick
+    TIMER_SWTick_t      period;    // 0: one-shot
+    TIMER_SWCallback_t  cb;
+    void               *arg;
+} TIMER_SW_t;
+
+/* ===================== API ===================== */
+void           TIMER_swInit(void);                 // starts the tick timer
+void           TIMER_swSetup(TIMER_SW_t *t, TIMER_SWCallback_t cb, void *arg);
+void           TIMER_swStart(TIMER_SW_t *t, TIMER_SWTick_t delay, TIMER_SWTick_t period);
+void           TIMER_swStop(TIMER_SW_t *t);
+bool           TIMER_swIsActive(const TIMER_SW_t *t);
+TIMER_SWTick_t TIMER_swRemaining(const TIMER_SW_t *t); // ticks to expiry, 0 if stopped
+TIMER_SWTick_t TIMER_swNow(void);                  // ticks since TIMER_swInit
+uint16_t       TIMER_swPeakWork(void);             // most timers handled by one tick
+void           TIMER_swTick(void);                 // ISR context only
+
+#endif /* TIMER_SW_INTERFACE_H_ */
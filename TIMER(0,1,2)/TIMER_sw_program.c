@@ -0,0 +1,458 @@
+//>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> TIMER_sw_program.c <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+// Layer: MCAL
+// SWC  : TIMER (software timers)
+// Target: ATmega32
+
+#include "TIMER_sw_interface.h"
+#include "TIMER_interface.h"
+#include "TIMER_config.h"
+#include "TIMER_private.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#if (TIMER_SW_WHEEL_BITS * TIMER_SW_LEVELS) > 24 || TIMER_SW_WHEEL_BITS > 8
+#error "TIMER_SW_WHEEL_BITS * TIMER_SW_LEVELS must be <= 24 (and bits <= 8)"
+#endif
+
+#define SWT_SLOTS   (1u << TIMER_SW_WHEEL_BITS)
+#define SWT_MASK    (SWT_SLOTS - 1u)
+#define SWT_RANGE   (1UL << (TIMER_SW_WHEEL_BITS * TIMER_SW_LEVELS))
+
+/* compare counts per tick at a divider; the smallest divider whose count
+   fits 8 bits gives the finest tick period */
+#define SWT_COUNTS(div)  (F_CPU / ((div) * TIMER_SW_TICK_HZ))
+
+#if TIMER_SW_TICKLESS
+/* ----- tickless: one tick per count of the free-running timer ----- */
+#define SWT_DIV  (F_CPU / TIMER_SW_TICK_HZ)
+#if TIMER_SW_HW_TIMER == 2
+#if SWT_DIV * TIMER_SW_TICK_HZ != F_CPU || (SWT_DIV != 1 && SWT_DIV != 8 && SWT_DIV != 32 && \
+    SWT_DIV != 64 && SWT_DIV != 128 && SWT_DIV != 256 && SWT_DIV != 1024)
+#error "tickless: TIMER_SW_TICK_HZ must be F_CPU / (1, 8, 32, 64, 128, 256 or 1024) on Timer2"
+#endif
+#define SWT_CLK  (SWT_DIV == 1 ? TIMER2_CLK_1 : SWT_DIV == 8 ? TIMER2_CLK_8 : \
+                  SWT_DIV == 32 ? TIMER2_CLK_32 : SWT_DIV == 64 ? TIMER2_CLK_64 : \
+                  SWT_DIV == 128 ? TIMER2_CLK_128 : SWT_DIV == 256 ? TIMER2_CLK_256 : \
+                  TIMER2_CLK_1024)
+#elif TIMER_SW_HW_TIMER == 0 || TIMER_SW_HW_TIMER == 1
+#if SWT_DIV * TIMER_SW_TICK_HZ != F_CPU || (SWT_DIV != 1 && SWT_DIV != 8 && SWT_DIV != 64 && \
+    SWT_DIV != 256 && SWT_DIV != 1024)
+#error "tickless: TIMER_SW_TICK_HZ must be F_CPU / (1, 8, 64, 256 or 1024) on Timer0/1"
+#endif
+#define SWT_CLK  (SWT_DIV == 1 ? TIMER01_CLK_1 : SWT_DIV == 8 ? TIMER01_CLK_8 : \
+                  SWT_DIV == 64 ? TIMER01_CLK_64 : SWT_DIV == 256 ? TIMER01_CLK_256 : \
+                  TIMER01_CLK_1024)
+#else
+#error "tickless: TIMER_SW_HW_TIMER must be 0, 1 or 2"
+#endif
+
+#if TIMER_SW_HW_TIMER == 1
+#define SWT_ID       TIMER_ID_1
+#define SWT_BITS     16
+#define SWT_TCNT     TCNT1
+#define SWT_OCR      OCR1A
+#define SWT_OCIE     OCIE1A
+#define SWT_OCF      OCF1A
+#define SWT_TOV      TOV1
+#define SWT_COMP_vect TIMER1_COMPA_vect
+#define SWT_DISPATCH_COMP()  TIMER_DISPATCH_T1_COMPA()
+#define SWT_DISPATCH_OVF()   TIMER_DISPATCH_T1_OVF()
+#define SWT_OVF_vect  TIMER1_OVF_vect
+typedef uint16_t swt_cnt_t;
+#else
+#define SWT_ID       ((TIMER_SW_HW_TIMER == 0) ? TIMER_ID_0 : TIMER_ID_2)
+#define SWT_BITS     8
+#if TIMER_SW_HW_TIMER == 0
+#define SWT_TCNT     TCNT0
+#define SWT_OCR      OCR0
+#define SWT_OCIE     OCIE0
+#define SWT_OCF      OCF0
+#define SWT_TOV      TOV0
+#define SWT_COMP_vect TIMER0_COMP_vect
+#define SWT_DISPATCH_COMP()  TIMER_DISPATCH_T0_COMP()
+#define SWT_DISPATCH_OVF()   TIMER_DISPATCH_T0_OVF()
+#define SWT_OVF_vect  TIMER0_OVF_vect
+#else
+#define SWT_TCNT     TCNT2
+#define SWT_OCR      OCR2
+#define SWT_OCIE     OCIE2
+#define SWT_OCF      OCF2
+#define SWT_TOV      TOV2
+#define SWT_COMP_vect TIMER2_COMP_vect
+#define SWT_DISPATCH_COMP()  TIMER_DISPATCH_T2_COMP()
+#define SWT_DISPATCH_OVF()   TIMER_DISPATCH_T2_OVF()
+#define SWT_OVF_vect  TIMER2_OVF_vect
+#endif
+typedef uint8_t swt_cnt_t;
+#endif
+
+/* on Timer1 the time base already extends the count: share it */
+#define SWT_TIMEBASE (TIMER_SW_HW_TIMER == 1 && TIMER_TIMEBASE_ENABLE)
+#if SWT_TIMEBASE && SWT_DIV != TIMER_TIMEBASE_DIV
+#error "tickless on Timer1: TIMER_SW_TICK_HZ must be F_CPU / TIMER_TIMEBASE_DIV"
+#endif
+
+#define SWT_CNT_MASK ((TIMER_SWTick_t)((1UL << SWT_BITS) - 1))
+/* counts that may pass while the compare is being armed, rounded up */
+#define SWT_LEAD     ((TIMER_SW_LEAD_CYCLES + SWT_DIV - 1) / SWT_DIV + 1)
+
+#elif TIMER_SW_HW_TIMER == 0
+#define SWT_DIV  (SWT_COUNTS(1) <= 256 ? 1 : SWT_COUNTS(8) <= 256 ? 8 : \
+                  SWT_COUNTS(64) <= 256 ? 64 : SWT_COUNTS(256) <= 256 ? 256 : 1024)
+#define SWT_CLK  (SWT_DIV == 1 ? TIMER01_CLK_1 : SWT_DIV == 8 ? TIMER01_CLK_8 : \
+                  SWT_DIV == 64 ? TIMER01_CLK_64 : SWT_DIV == 256 ? TIMER01_CLK_256 : \
+                  TIMER01_CLK_1024)
+#define SWT_ID   TIMER_ID_0
+#elif TIMER_SW_HW_TIMER == 2
+#define SWT_DIV  (SWT_COUNTS(1) <= 256 ? 1 : SWT_COUNTS(8) <= 256 ? 8 : \
+                  SWT_COUNTS(32) <= 256 ? 32 : SWT_COUNTS(64) <= 256 ? 64 : \
+                  SWT_COUNTS(128) <= 256 ? 128 : SWT_COUNTS(256) <= 256 ? 256 : 1024)
+#define SWT_CLK  (SWT_DIV == 1 ? TIMER2_CLK_1 : SWT_DIV == 8 ? TIMER2_CLK_8 : \
+                  SWT_DIV == 32 ? TIMER2_CLK_32 : SWT_DIV == 64 ? TIMER2_CLK_64 : \
+                  SWT_DIV == 128 ? TIMER2_CLK_128 : SWT_DIV == 256 ? TIMER2_CLK_256 : \
+                  TIMER2_CLK_1024)
+#define SWT_ID   TIMER_ID_2
+#elif TIMER_SW_HW_TIMER != 255
+#error "TIMER_SW_HW_TIMER must be 0, 2 or 255"
+#endif
+
+#if defined(SWT_DIV) && !TIMER_SW_TICKLESS
+#if SWT_COUNTS(SWT_DIV) > 256 || SWT_COUNTS(SWT_DIV) < 2
+#error "TIMER_SW_TICK_HZ out of reach of the 8-bit tick timer at this F_CPU"
+#endif
+#endif
+
+/* ===== State ===== */
+
+/* one list head per slot; level 0 holds what expires in the next 2^bits ticks */
+static TIMER_SW_t *swt_wheel[TIMER_SW_LEVELS][SWT_SLOTS];
+static volatile TIMER_SWTick_t swt_now;
+static TIMER_SW_t *swt_expired;     /* slot being run by the tick */
+static uint16_t swt_peak;
+
+#if TIMER_SW_TICKLESS
+#if !SWT_TIMEBASE
+static volatile TIMER_SWTick_t swt_epoch;  /* counter overflows */
+#endif
+static TIMER_SWTick_t swt_target;          /* next event the hardware waits for */
+static bool swt_armed;                     /* false: wheel empty */
+#endif
+
+/* ===== Lists: pprev points at whatever points at the node, so unlinking
+   needs neither the slot nor a walk ===== */
+
+static inline void swt_link(TIMER_SW_t **head, TIMER_SW_t *t) {
+    t->next = *head;
+    if (t->next) t->next->pprev = &t->next;
+    *head = t;
+    t->pprev = head;
+}
+
+static inline void swt_unlink(TIMER_SW_t *t) {
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    t->pprev = 0;
+}
+
+/* Level k holds delays in [2^(k*bits), 2^((k+1)*bits)), at the slot given
+   by bits k*bits.. of the expiry tick. That slot is moved down exactly when
+   the levels below wrap to it, i.e. before the timer is due. Delays past
+   the top level wait in the top slot that comes round last.
+   Returns the tick the wheel next has to look at the timer (tickless). */
+static TIMER_SWTick_t swt_place(TIMER_SW_t *t) {
+    TIMER_SWTick_t e = t->expires;
+    TIMER_SWTick_t d = e - swt_now;
+    uint8_t lvl = 0;
+
+    if (d >= SWT_RANGE) {
+        d = SWT_RANGE - 1;
+        e = swt_now + d;
+    }
+    while (d >= SWT_SLOTS) {
+        d >>= TIMER_SW_WHEEL_BITS;
+        e >>= TIMER_SW_WHEEL_BITS;
+        lvl++;
+    }
+    swt_link(&swt_wheel[lvl][(uint8_t)e & SWT_MASK], t);
+#if TIMER_SW_TICKLESS
+    return e << (lvl * TIMER_SW_WHEEL_BITS);
+#else
+    return 0;
+#endif
+}
+
+/* Cascade moves down, then expiry, at tick `now`. Ticks between swt_now
+   and `now` must have nothing to do (tick mode: now = swt_now + 1). */
+static void swt_step(TIMER_SWTick_t now)
+{
+    TIMER_SWTick_t j = now;
+    TIMER_SW_t *t, *n;
+    uint16_t work = 0;
+    uint8_t lvl = 0;
+
+    swt_now = now;
+
+    /* level k-1 wrapped: move level k's current slot down */
+    while (((uint8_t)j & SWT_MASK) == 0 && ++lvl < TIMER_SW_LEVELS) {
+        j >>= TIMER_SW_WHEEL_BITS;
+        t = swt_wheel[lvl][(uint8_t)j & SWT_MASK];
+        swt_wheel[lvl][(uint8_t)j & SWT_MASK] = 0;
+        for (; t; t = n) {
+            n = t->next;
+            swt_place(t);
+            work++;
+        }
+    }
+
+    /* everything in this level 0 slot expires now; it is run from a
+       module list so a callback can stop any timer still waiting in it */
+    swt_expired = swt_wheel[0][(uint8_t)now & SWT_MASK];
+    swt_wheel[0][(uint8_t)now & SWT_MASK] = 0;
+    if (swt_expired) swt_expired->pprev = &swt_expired;
+
+    while ((t = swt_expired) != 0) {
+        swt_unlink(t);
+        if (t->period) {
+            t->expires += t->period;   /* from the due tick: no drift */
+            swt_place(t);
+        }
+        work++;
+        t->cb(t->arg);
+    }
+
+    if (work > swt_peak) swt_peak = work;
+}
+
+#if TIMER_SW_TICKLESS
+/* ===== Tickless: the compare unit only fires for the next event ===== */
+
+/* extended count; interrupts off. A pending overflow with a small count
+   means the counter wrapped after the last overflow ISR. */
+#if SWT_TIMEBASE
+static inline TIMER_SWTick_t swt_hw_now(void)
+{
+    return TIMER_nowTicks();
+}
+#else
+static TIMER_SWTick_t swt_hw_now(void)
+{
+    TIMER_SWTick_t ep = swt_epoch;
+    swt_cnt_t c = SWT_TCNT;
+
+    if ((TIFR & (1<<SWT_TOV)) && c < (swt_cnt_t)(SWT_CNT_MASK / 2)) ep++;
+    return (ep << SWT_BITS) | c;
+}
+#endif
+
+/* Earliest tick after swt_now at which the wheel has work: a level 0 slot
+   expiring, or an occupied upper slot coming due to move down. At most
+   2^bits slots per level are looked at, upper levels only while they can
+   still beat what was found below. */
+static bool swt_next_event(TIMER_SWTick_t *next)
+{
+    TIMER_SWTick_t best = 0, base, cand;
+    bool found = false;
+    uint16_t o;
+    uint8_t lvl, sh = 0;
+
+    for (lvl = 0; lvl < TIMER_SW_LEVELS; lvl++, sh += TIMER_SW_WHEEL_BITS) {
+        base = swt_now >> sh;
+        if (found && (TIMER_SWTick_t)(((base + 1) << sh) - swt_now) >= best) break;
+        for (o = 1; o <= SWT_SLOTS; o++) {
+            if (swt_wheel[lvl][(uint8_t)(base + o) & SWT_MASK]) {
+                cand = ((base + o) << sh) - swt_now;
+                if (!found || cand < best) { best = cand; found = true; }
+                break;
+            }
+        }
+    }
+    *next = swt_now + best;
+    return found;
+}
+
+/* Run whatever is due (late ISR, deadlines inside the lead), then arm the
+   compare for the next event if it falls in the current counter period;
+   otherwise the overflow ISR arms it when that period starts. */
+static void swt_program(void)
+{
+    TIMER_SWTick_t next, hw;
+
+    for (;;) {
+        if (!swt_next_event(&next)) {
+            swt_armed = false;
+            TIMSK &= ~(1<<SWT_OCIE);
+            return;
+        }
+        swt_target = next;
+        swt_armed = true;
+
+        hw = swt_hw_now();
+        if ((int32_t)(next - hw) > (int32_t)SWT_LEAD) {
+            if (((next ^ hw) & ~SWT_CNT_MASK) == 0) {
+                SWT_OCR = (swt_cnt_t)next;
+                TIFR = (1<<SWT_OCF);
+                TIMSK |= (1<<SWT_OCIE);
+            } else {
+                TIMSK &= ~(1<<SWT_OCIE);
+            }
+            return;
+        }
+        while ((int32_t)(next - swt_hw_now()) > 0) { }   /* < SWT_LEAD counts */
+        swt_step(next);
+    }
+}
+#endif
+
+/* ===== API Implementation ===== */
+
+void TIMER_swInit(void)
+{
+#if TIMER_SW_TICKLESS && SWT_TIMEBASE
+    TIMER_timebaseInit();
+#elif TIMER_SW_TICKLESS
+    const TIMER_Config_t cfg = {
+        .id = SWT_ID,
+        .mode = TIMER_MODE_NORMAL,
+        .clock_sel = SWT_CLK,
+        .int_ovf_enable = 1
+    };
+    TIMER_init(&cfg);
+#elif defined(SWT_ID)
+    const TIMER_Config_t cfg = {
+        .id = SWT_ID,
+        .mode = TIMER_MODE_CTC,
+        .clock_sel = SWT_CLK,
+        .ocrA_init = SWT_COUNTS(SWT_DIV) - 1,
+        .int_ocA_enable = 1
+    };
+    TIMER_init(&cfg);
+#endif
+}
+
+void TIMER_swSetup(TIMER_SW_t *t, TIMER_SWCallback_t cb, void *arg)
+{
+    if (!t) return;
+    t->next = 0;
+    t->pprev = 0;
+    t->period = 0;
+    t->cb = cb;
+    t->arg = arg;
+}
+
+void TIMER_swStart(TIMER_SW_t *t, TIMER_SWTick_t delay, TIMER_SWTick_t period)
+{
+    if (!t || !t->cb) return;
+    if (delay == 0) delay = 1;     /* the current tick's slot has already run */
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (t->pprev) swt_unlink(t);
+        t->period = period;
+#if TIMER_SW_TICKLESS
+        /* an idle wheel may be far behind the counter: nothing to move */
+        if (!swt_armed) swt_now = swt_hw_now();
+        t->expires = swt_hw_now() + delay;
+        if ((int32_t)(swt_place(t) - swt_target) < 0 || !swt_armed) swt_program();
+#else
+        t->expires = swt_now + delay;
+        swt_place(t);
+#endif
+    }
+}
+
+void TIMER_swStop(TIMER_SW_t *t)
+{
+    if (!t) return;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (t->pprev) swt_unlink(t);
+    }
+}
+
+bool TIMER_swIsActive(const TIMER_SW_t *t)
+{
+    bool a = false;
+    if (!t) return false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        a = (t->pprev != 0);
+    }
+    return a;
+}
+
+TIMER_SWTick_t TIMER_swRemaining(const TIMER_SW_t *t)
+{
+    TIMER_SWTick_t r = 0;
+    if (!t) return 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+#if TIMER_SW_TICKLESS
+        if (t->pprev) r = t->expires - swt_hw_now();
+        if ((int32_t)r < 0) r = 0;
+#else
+        if (t->pprev) r = t->expires - swt_now;
+#endif
+    }
+    return r;
+}
+
+TIMER_SWTick_t TIMER_swNow(void)
+{
+    TIMER_SWTick_t n;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+#if TIMER_SW_TICKLESS
+        n = swt_hw_now();
+#else
+        n = swt_now;
+#endif
+    }
+    return n;
+}
+
+uint16_t TIMER_swPeakWork(void)
+{
+    uint16_t p;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        p = swt_peak;
+    }
+    return p;
+}
+
+void TIMER_swTick(void)
+{
+#if !TIMER_SW_TICKLESS
+    swt_step(swt_now + 1);
+#endif
+}
+
+#if TIMER_SW_TICKLESS
+ISR(SWT_COMP_vect)
+{
+    swt_program();
+    SWT_DISPATCH_COMP();
+}
+
+/* overflow chaining: the period the next event falls in has started */
+#if SWT_TIMEBASE
+void timer_sw_overflow(void)    /* from the time base's TIMER1_OVF_vect */
+{
+#else
+ISR(SWT_OVF_vect)
+{
+    swt_epoch++;
+#endif
+    if (swt_armed && ((swt_target ^ swt_hw_now()) & ~SWT_CNT_MASK) == 0)
+        swt_program();
+#if !SWT_TIMEBASE
+    SWT_DISPATCH_OVF();
+#endif
+}
+#elif TIMER_SW_HW_TIMER == 0
+ISR(TIMER0_COMP_vect)
+{
+    TIMER_swTick();
+    TIMER_DISPATCH_T0_COMP();
+}
+#elif TIMER_SW_HW_TIMER == 2
+ISR(TIMER2_COMP_vect)
+{
+    TIMER_swTick();
+    TIMER_DISPATCH_T2_COMP();
+}
+#endif